@@ -15,19 +15,95 @@ April 2020
 #include <bits/stdc++.h>
 #include <stdlib.h>
 #include <math.h>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <sched.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GAUSS_X86_KERNELS
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#define GAUSS_PERF_COUNTERS
+#endif
+#ifdef GAUSS_USE_MPI
+#include <mpi.h>
+#endif
 
 using namespace std;
 
 const char endOfLine = '\n';
 static string dataLogger = "\n***New Data Logger***";
+static bool silentMode = false;//set for the whole batch run - workers do not touch the data logger or the screen
+
+enum affinityPolicy{
+    affinityNone,//threads are left to the scheduler
+    affinityCompact,//threads fill the processors of one socket before the next one
+    affinitySpread//threads alternate between sockets
+};
+
+const char* affinityName[] = { "none", "compact", "spread" };
 
 struct parallelParam{
     omp_sched_t scheduleType;
     int chunkSize;
     int wantedThreads;
+    int blockSize;//panel width of the blocked factorization, 1 turns blocking off
+    bool taskGraph;//tiled factorization on OpenMP tasks instead of worksharing loops
+    affinityPolicy affinity;//placement of the threads, GAUSS_AFFINITY=none|compact|spread sets the default
+};
+
+static parallelParam parameters ={ omp_sched_auto, 100, 8, 64, false, affinityNone };//default parallel parameters
+
+static bool verification = false;//the sequential reference elimination is run and compared with every solve
+
+enum structureType{
+    structureDense,
+    structureUpperTriangular,
+    structureLowerTriangular,
+    structureTridiagonal,
+    structureBanded
+};
+
+enum structureHintType{
+    hintDetect,//bandwidths are measured for every system
+    hintDense,
+    hintBanded,//banded path for any measured bandwidth
+    hintUpperTriangular,//hinted shapes are trusted, entries outside of them are not read
+    hintLowerTriangular,
+    hintTridiagonal
+};
+
+static structureHintType structureHint = hintDetect;
+
+const int bandedFraction = 4;//detected bands are solved by the banded path when their stored width is at most n/bandedFraction
+const int bandedParallelWork = 16384;//multiply-adds of one banded elimination step above which its rows are updated in parallel
+
+static bool useTuning = true;//parameters of the elimination are taken from the tuning cache by the amount of equations
+const string tuningCacheName = "TuningCache.txt";
+
+enum precisionType{
+    precisionFloat,
+    precisionDouble,
+    precisionMixed//factorization in float, iterative refinement with residuals in double
 };
 
-static parallelParam parameters ={ omp_sched_auto, 100, 8 };//default parallel parameters
+static precisionType precision = precisionFloat;
+
+const int maxRefinementSteps = 10;//limit of iterative refinement steps in the mixed precision mode
+
+const int minimumTileSize = 16;//narrowest tile of the task graph factorization
+
+const int updateTileWidth = 256;//columns of the trailing update handled at once, sized for L1 together with a row block of U
+
+const int substitutionBlock = 128;//rows of a diagonal block of the blocked triangular solve
+const int substitutionMinimum = 512;//smaller systems are substituted row by row in one thread
 
 // Get current date/time, format is YYYY-MM-DD.HH:mm:ss
 const std::string currentDateTime() {
@@ -40,630 +116,6644 @@ const std::string currentDateTime() {
     return buf;
 }
 
-class cMatrix
-{
-public:
-    int width;
-    int height;
-    float** data;
-    double timeSeq, timePar;
-    bool errorFlag;
+//*************profiler*******************************
+//phase timings are added into preallocated per-thread slots and exported as JSON lines after every operation;
+//enabled with GAUSS_PROFILE=1, otherwise every probe is a single test of a flag
+//GAUSS_PROFILE=2 also reads hardware counters of the calling thread at every probe (perf_event_open, one
+//system call per probe), counters the kernel or the processor does not offer are left out
 
-    cMatrix(int w, int h);//default constructor, sets all elements to 0
-    cMatrix(string sourceName);//reading constructor
-    cMatrix(const cMatrix& source);//copy constructor
-    ~cMatrix();
-    void mPrint(string name);//print the elements to the file
-    void screenPrint();//print the elements to the screen
+enum profilePhase{
+    phasePivotSearch,
+    phaseRowSwap,
+    phasePanel,//panel columns and the rows of U to the right of the panel
+    phaseTrailingUpdate,
+    phaseBackSubstitution,
+    phaseLoad,
+    phaseStore,
+    phaseCount
 };
 
-cMatrix::cMatrix(int w, int h)//default constructor
-{
-    width = w;
-    height = h;
-    timePar = 0;
-    timeSeq = 0;
-    errorFlag = false;
-    data = new float* [height];
-    for (int i = 0; i < height; i++)
+const char* profilePhaseName[phaseCount] = { "pivot search", "row swap", "panel", "trailing update", "back substitution", "load", "store" };
+
+enum profileCounter{
+    counterCycles,
+    counterInstructions,
+    counterCacheMisses,//last level cache misses
+    counterFloat,//retired floating point arithmetic instructions, a vector instruction counts once
+    counterCount
+};
+
+const char* profileCounterName[counterCount] = { "cycles", "instructions", "llc misses", "fp arith" };
+
+const int profileMaxThreads = 256;//live threads past this share slots, their counts are merged
+
+struct alignas(64) profileSlot{//one per thread, on its own cache lines
+    unsigned long long calls[phaseCount];
+    unsigned long long nanoseconds[phaseCount];
+    unsigned long long counts[phaseCount][counterCount];
+};
+
+//state of the profiler at the start of a probe
+struct profileMark{
+    unsigned long long nanoseconds;
+    unsigned long long counts[counterCount];
+};
+
+static profileSlot profileSlots[profileMaxThreads];
+static atomic<int> profileThreads(0);//slots handed out so far, never more than profileMaxThreads
+static bool profiling = (getenv("GAUSS_PROFILE") != NULL && atoi(getenv("GAUSS_PROFILE")) != 0);
+static bool counting = profiling && atoi(getenv("GAUSS_PROFILE")) >= 2;
+static atomic<unsigned> countersOpened(0);//bit per counter some thread could open
+const string profileName = "Profile.jsonl";
+
+//counter group of one thread, opened on its first probe
+struct counterGroup{
+    int leader = -1;
+    int position[counterCount];//index of the counter in a group read, -1 when it is not counted
+    int descriptor[counterCount];//of every member, the leader first
+    int members = 0;
+
+    counterGroup()
     {
-        data[i] = new float[width];
-        for (int j = 0; j < width; j++)
+#ifdef GAUSS_PERF_COUNTERS
+        unsigned long long config[counterCount] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), 0 };
+        unsigned type[counterCount] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_RAW };
+        bool floatEvent = false;
+#ifdef GAUSS_X86_KERNELS
+        __builtin_cpu_init();
+        floatEvent = __builtin_cpu_is("intel");
+        config[counterFloat] = 0xc7 | (0xff << 8);//FP_ARITH_INST_RETIRED, every width and precision
+#endif
+        for (int c = 0; c < counterCount; c++)
+        {
+            position[c] = -1;
+            if(c == counterFloat && !floatEvent)
+            {
+                continue;
+            }
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type[c];
+            attr.config = config[c];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);//this thread on any processor
+            if(fd < 0)
+            {
+                continue;
+            }
+            if(leader < 0)
+            {
+                leader = fd;
+            }
+            descriptor[members] = fd;
+            position[c] = members++;
+            countersOpened |= 1u << c;
+        }
+#else
+        fill(position, position + counterCount, -1);
+#endif
+    }
+
+    ~counterGroup()//threads started per job would run out of descriptors otherwise
+    {
+        for (int m = 0; m < members; m++)
         {
-            data[i][j] = 0;
+            close(descriptor[m]);
         }
     }
-}
+};
 
-cMatrix::cMatrix(const cMatrix& source)//copy constructor
+//current values of the counters of the calling thread, scaled up when the kernel multiplexed them
+inline void counterRead(unsigned long long* counts)
 {
-    srand( time( NULL ) );
-    width = source.width;
-    height = source.height;
-    timePar = source.timePar;
-    timeSeq = source.timeSeq;
-    data = new float* [height];
-    for (int i = 0; i < height; i++)
+    static thread_local counterGroup group;
+    unsigned long long buffer[3 + counterCount] = {};//members, time enabled, time running, values
+    if(group.leader < 0 || read(group.leader, buffer, sizeof(buffer)) <= 0)
     {
-        data[i] = new float[width];
-        for (int j = 0; j < width; j++)
+        return;
+    }
+    double scale = (buffer[2] > 0 && buffer[2] < buffer[1]) ? (double)buffer[1]/buffer[2] : 1;
+    for (int c = 0; c < counterCount; c++)
+    {
+        if(group.position[c] >= 0)
         {
-            data[i][j] = source.data[i][j];
+            counts[c] = (unsigned long long)(buffer[3 + group.position[c]]*scale);
         }
     }
 }
 
-cMatrix::cMatrix(string sourceName)//file copy constructor
+inline profileMark profileClock()
 {
-    errorFlag = false;
-    string line;
-    string s;
+    profileMark mark = {};
+    if(!profiling)
+    {
+        return mark;
+    }
+    if(counting)
+    {
+        counterRead(mark.counts);
+    }
+    mark.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    return mark;
+}
 
-    dataLogger += endOfLine;
-    dataLogger += "Reading file: ";
-    dataLogger += sourceName;
-    dataLogger += "...";
-    dataLogger += "time: ";
-    dataLogger += currentDateTime();
-    dataLogger += "...";
+//slot of a thread, taken on its first probe and given back when it exits, so the threads started per job by
+//batch runs and asynchronous loaders reuse the slots of finished ones; past profileMaxThreads live threads
+//a slot is shared, which the atomic adds of the probes tolerate
+struct profileLease{
+    int slot;
+    bool shared;
 
+    profileLease()
+    {
+        static int overflow = 0;
+        lock_guard<mutex> lock(leaseMutex());
+        vector<int>& returned = returnedSlots();
+        shared = returned.empty() && profileThreads >= profileMaxThreads;
+        if(!returned.empty())
+        {
+            slot = returned.back();
+            returned.pop_back();
+        }
+        else
+        {
+            slot = shared ? overflow++ % profileMaxThreads : profileThreads++;
+        }
+    }
 
-    ifstream sourceFile;
-    sourceFile.open(sourceName);
+    ~profileLease()
+    {
+        lock_guard<mutex> lock(leaseMutex());
+        if(!shared)
+        {
+            returnedSlots().push_back(slot);
+        }
+    }
 
-    if (!sourceFile.is_open()){
-        cout<<"Cannot open files."<<endl;
-        dataLogger += "Cannot open files.";
-        errorFlag = true;
-        width = 1;
-        height = 1;
-        data = new float*[1];
-        data[0] = new float;
-        data[0][0] = 0;
-        return;
+    static mutex& leaseMutex()
+    {
+        static mutex m;
+        return m;
     }
 
-    sourceFile>>height;
-    if(sourceFile.fail()){
-        cout<<"Cannot read files."<<endl;
-        dataLogger += "Cannot read files.";
-        errorFlag = true;
-        width = 1;
-        height = 1;
-        data = new float*[1];
-        data[0] = new float;
-        data[0][0] = 0;
-        return;
+    static vector<int>& returnedSlots()
+    {
+        static vector<int> returned;
+        return returned;
     }
+};
 
-    width = height + 1;
-    /*sourceFile>>width;
-    if(sourceFile.fail()){
-        cout<<"Cannot read files."<<endl;
-        dataLogger += "Cannot read files.";
-        errorFlag = true;
-        width = 1;
-        height = 1;
-        data = new float*[1];
-        data[0] = new float;
-        data[0][0] = 0;
-        return;
-    }*/
+inline int profileSlotIndex()
+{
+    static thread_local profileLease lease;
+    return lease.slot;
+}
 
-    getline(sourceFile, line); //before reading rows we need to change line
+inline void profileCount(unsigned long long& total, unsigned long long amount)
+{
+    __atomic_fetch_add(&total, amount, __ATOMIC_RELAXED);
+}
 
-    data = new float* [height];
-    for (int i = 0; i < height; i++)
+//adds the time and the counts since start to the phase of the calling thread
+inline void profileAdd(profilePhase phase, const profileMark& start)
+{
+    if(profiling)
     {
-        data[i] = new float[width];
-        getline(sourceFile, line);
-
-        for (int j = 0; j < width; j++)
+        profileSlot& slot = profileSlots[profileSlotIndex()];
+        profileMark end = profileClock();
+        profileCount(slot.calls[phase], 1);
+        profileCount(slot.nanoseconds[phase], end.nanoseconds - start.nanoseconds);
+        for (int c = 0; c < counterCount && counting; c++)
         {
-            s = line.substr(0,line.find(";"));
-            line.erase(0,s.length()+1);
-            data[i][j] = atof(s.c_str());
-
-            if(sourceFile.fail()){
-                cout<<"Cannot read files."<<endl;
-                dataLogger += "Cannot read files.";
-                errorFlag = true;
-                for (int i = 0; i < height; i++){//to prevent memory leaks
-                    delete data[i];
-                }
-                delete data;
-                width = 1;
-                height = 1;
-                data = new float*[1];
-                data[0] = new float;
-                data[0][0] = 0;
-                return;
-            }
+            profileCount(slot.counts[phase][c], end.counts[c] - start.counts[c]);
         }
     }
-    dataLogger += " OK";
-    cout<<"File reading: OK"<<endl;
 }
 
-cMatrix::~cMatrix()//destructor deallocates memory
+//counts of thread t summed over the phases of the factorization and the substitution
+void counterTotals(int t, unsigned long long* totals)
 {
-    for (int i = 0; i < height; i++)
+    for (int c = 0; c < counterCount; c++)
     {
-        delete data[i];
+        totals[c] = 0;
+        for (int p = phasePivotSearch; p <= phaseBackSubstitution; p++)
+        {
+            totals[c] += profileSlots[t].counts[p][c];
+        }
     }
-    delete data;
 }
 
-void cMatrix::screenPrint()//printing to screen
+static unsigned long long counterBaseline[profileMaxThreads][counterCount];
+
+//start of a measured part, its counts are reported by counterReport
+void counterMark()
 {
-    using namespace std;
+    for (int t = 0; t < profileMaxThreads && counting; t++)
+    {
+        counterTotals(t, counterBaseline[t]);
+    }
+}
 
-    for (int i = 0; i < height; i++)
+//achieved floating point rate and bandwidth of a part of time seconds, with the counters of every thread
+//when they are read; a low arithmetic intensity with a low IPC points at a memory-bound run
+void counterReport(double time, double flops, double bytes)
+{
+    time = max(time, 1e-9);
+    if(flops > 0)//structured solves are not counted
     {
-        for (int j = 0; j < width; j++)
+        cout<<"Achieved: "<<flops/time*1e-9<<" GFLOP/s, "<<bytes/time*1e-9<<" GB/s, "<<flops/max(bytes, 1.0)<<" flops per byte"<<endl;
+        dataLogger += to_string(flops/time*1e-9);
+        dataLogger += " GFLOP/s, ";
+    }
+    if(!counting)
+    {
+        return;
+    }
+    if(countersOpened == 0)
+    {
+        cout<<"Hardware counters: not available on this system"<<endl;
+        return;
+    }
+    int threads = profileThreads.load();
+    unsigned long long sum[counterCount] = {};
+    for (int t = 0; t < threads; t++)
+    {
+        unsigned long long totals[counterCount];
+        counterTotals(t, totals);
+        bool active = false;
+        for (int c = 0; c < counterCount; c++)
+        {
+            totals[c] -= counterBaseline[t][c];
+            sum[c] += totals[c];
+            active = active || totals[c] > 0;
+        }
+        if(!active)
+        {
+            continue;
+        }
+        cout<<"Thread "<<t<<":";
+        for (int c = 0; c < counterCount; c++)
+        {
+            if(countersOpened & (1u << c))
+            {
+                cout<<" "<<profileCounterName[c]<<" "<<totals[c]<<",";
+            }
+        }
+        if(totals[counterCycles] > 0)
         {
-            cout<<data[i][j]<<"\t";
+            cout<<" IPC "<<(double)totals[counterInstructions]/totals[counterCycles];
         }
         cout<<endl;
     }
+    if(sum[counterCycles] > 0)
+    {
+        cout<<"All threads: IPC "<<(double)sum[counterInstructions]/sum[counterCycles];
+        dataLogger += "IPC ";
+        dataLogger += to_string((double)sum[counterInstructions]/sum[counterCycles]);
+        dataLogger += ", ";
+    }
+    else
+    {
+        cout<<"All threads:";
+    }
+    if(countersOpened & (1u << counterCacheMisses))
+    {
+        double missBytes = sum[counterCacheMisses]*64.0;//a miss brings one cache line
+        cout<<", last level cache misses "<<missBytes/time*1e-9<<" GB/s, "<<flops/max(missBytes, 1.0)<<" flops per missed byte";
+        dataLogger += to_string(missBytes/time*1e-9);
+        dataLogger += " GB/s from misses, ";
+    }
     cout<<endl;
 }
 
-void cMatrix::mPrint(string name)//printing to file
+//appends one line per thread and phase to the profile and clears the slots, called outside of parallel regions
+void profileWrite(string operation)
 {
-    using namespace std;
-
-    ofstream resultFile;
-    errorFlag = false;
-
-    string outputName = name;
-    outputName += "_";
-    outputName += to_string(timeSeq);
-    outputName += "_";
-    outputName += to_string(timePar);
-    outputName += ".csv";
-
-    dataLogger += endOfLine;
-    dataLogger += "File writing... ";
-    dataLogger += outputName;
+    if(!profiling)
+    {
+        return;
+    }
+    ofstream profileFile(profileName, ios::app);
+    string time = currentDateTime();
+    int threads = profileThreads.load();
+    for (int t = 0; t < threads; t++)
+    {
+        for (int p = 0; p < phaseCount; p++)
+        {
+            if(profileSlots[t].calls[p] > 0)
+            {
+                profileFile<<"{\"time\": \""<<time<<"\", \"operation\": \""<<operation<<"\", \"thread\": "<<t
+                    <<", \"phase\": \""<<profilePhaseName[p]<<"\", \"calls\": "<<profileSlots[t].calls[p]
+                    <<", \"ns\": "<<profileSlots[t].nanoseconds[p];
+                for (int c = 0; c < counterCount && counting; c++)
+                {
+                    if(countersOpened & (1u << c))
+                    {
+                        profileFile<<", \""<<profileCounterName[c]<<"\": "<<profileSlots[t].counts[p][c];
+                    }
+                }
+                profileFile<<"}"<<endOfLine;
+            }
+        }
+    }
+    memset(profileSlots, 0, sizeof(profileSlots));
+}
 
-    dataLogger += "...time: ";
-    dataLogger += currentDateTime();
-    dataLogger += "...";
+//*************thread placement*******************************
+//threads are pinned to processors in the order of the affinity policy; the bytes moved by the elimination
+//loops are counted per thread together with the socket it ran on, so the timing report can show the
+//bandwidth of every socket
 
-    resultFile.open (outputName);
+const size_t firstTouchBytes = 1 << 20;//smaller matrices are initialized by the allocating thread alone
 
-    //resultFile<<height<<endl;
-    resultFile<<width<<endl;
+struct processorTopology{
+    cpu_set_t allowed;//processors of the process at startup
+    vector<int> socket;//socket of every processor number
+    int sockets;
+};
 
-    for (int i = 0; i < height; i++)
-    {
-        for (int j = 0; j < width; j++)
+//allowed processors and their sockets, read once from the scheduler and sysfs
+const processorTopology& hostTopology()
+{
+    static processorTopology topology = []() {
+        processorTopology t;
+        CPU_ZERO(&t.allowed);
+        if(sched_getaffinity(0, sizeof(t.allowed), &t.allowed) != 0)
         {
-            resultFile<<fixed << setprecision(6)<<data[i][j];
-            if(j<(width-1)){
-                resultFile<<";";
+            CPU_SET(0, &t.allowed);
+        }
+        t.socket.assign(CPU_SETSIZE, 0);
+        t.sockets = 1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if(!CPU_ISSET(cpu, &t.allowed))
+            {
+                continue;
+            }
+            ifstream package("/sys/devices/system/cpu/cpu" + to_string(cpu) + "/topology/physical_package_id");
+            int id = 0;
+            if(package>>id && id >= 0)
+            {
+                t.socket[cpu] = id;
+                t.sockets = max(t.sockets, id + 1);
             }
         }
-        resultFile<<endl;
-    }
-    resultFile<<endl;
-    resultFile.close();
-    dataLogger += " OK";
+        return t;
+    }();
+    return topology;
 }
 
-void updateDataLog()//printing data log to file and clearing it
+//processors in the order threads are placed on them
+vector<int> placementOrder(affinityPolicy policy)
 {
-    using namespace std;
-    ofstream resultFile;
-    string outputName = "DataLog.txt";
-    resultFile.open (outputName,std::ofstream::app);
-    if (resultFile.is_open())
+    const processorTopology& topology = hostTopology();
+    vector<vector<int>> bySocket(topology.sockets);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
     {
-        resultFile<<endl;
-        resultFile<<dataLogger;
-        resultFile.close();
+        if(CPU_ISSET(cpu, &topology.allowed))
+        {
+            bySocket[topology.socket[cpu]].push_back(cpu);
+        }
+    }
+    vector<int> order;
+    if(policy == affinitySpread)
+    {
+        for (size_t k = 0; order.size() < (size_t)CPU_COUNT(&topology.allowed); k++)
+        {
+            for (int s = 0; s < topology.sockets; s++)
+            {
+                if(k < bySocket[s].size())
+                {
+                    order.push_back(bySocket[s][k]);
+                }
+            }
+        }
     }
     else
-        cout << "Unable to open file";
-    dataLogger = "";
+    {
+        for (int s = 0; s < topology.sockets; s++)
+        {
+            order.insert(order.end(), bySocket[s].begin(), bySocket[s].end());
+        }
+    }
+    return order;
 }
 
-void readDataLog()//reading data log file and printing it to the screen
-{
-    using namespace std;
-    string line = "";
-    string name = "DataLog.txt";
-    ifstream dataFile;
-
-    dataFile.open(name);
+static int affinityOffset = 0;//first place of this process, set to the place of its first thread by MPI ranks sharing a host
 
-    if (!dataFile.is_open()){
-        cout<<"Cannot open data files."<<endl;
+//pins the worker threads of the next parallel regions of parameters.wantedThreads threads, called with the
+//other settings of a run; the runtime keeps the same threads for regions of that size
+//the calling thread keeps every processor, so threads it starts later - asynchronous loaders and writers and
+//their own teams - are not stacked onto one processor; the scheduler usually keeps it on the place left free
+void applyAffinity()
+{
+    static affinityPolicy applied = affinityNone;
+    if(parameters.affinity == affinityNone && applied == affinityNone)
+    {
         return;
     }
-    if(dataFile.fail()){
-        cout<<"Cannot read files."<<endl;
-    }
-    do
+    applied = parameters.affinity;
+    const processorTopology& topology = hostTopology();
+    vector<int> order = placementOrder(parameters.affinity);
+    #pragma omp parallel num_threads(parameters.wantedThreads)
     {
-        cout<<line;
-        getline(dataFile, line);//gets line from a file
-        cout<<endl;//prints it to the screen
-    }while(!dataFile.fail());
+        cpu_set_t set = topology.allowed;
+        int thread = omp_get_thread_num();
+        if(parameters.affinity != affinityNone && !order.empty() && thread > 0)
+        {
+            CPU_ZERO(&set);
+            CPU_SET(order[(affinityOffset + thread) % order.size()], &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
 }
 
-//changes options of parallel tasks
-void parallelOptionChange()
+affinityPolicy affinityFromName(const char* name)
 {
-    int optionChosen;//chosen option
+    string policy = (name != NULL) ? name : "";
+    return (policy == "compact") ? affinityCompact : (policy == "spread") ? affinitySpread : affinityNone;
+}
 
-    dataLogger += endOfLine;
-    dataLogger += "Changing parallel options: ";
-    dataLogger += currentDateTime();
-    dataLogger += ", ";
+struct alignas(64) trafficSlot{//one per thread, on its own cache line
+    unsigned long long bytes;
+    int socket;//where the thread ran the last time it added bytes
+};
 
-    do{
+static trafficSlot trafficSlots[profileMaxThreads];//indexed by the profiler slot of the thread
+
+//adds bytes read and written by the calling thread
+inline void trafficAdd(size_t bytes)
+{
+    trafficSlot& slot = trafficSlots[profileSlotIndex()];
+    int cpu = sched_getcpu();
+    profileCount(slot.bytes, bytes);
+    __atomic_store_n(&slot.socket, (cpu >= 0 && cpu < CPU_SETSIZE) ? hostTopology().socket[cpu] : 0, __ATOMIC_RELAXED);
+}
+
+//floating point operations of the elimination of n rows of width columns and of the back substitution
+double eliminationFlops(int n, int width)
+{
+    double flops = 0;
+    for (int i = 0; i < n; i++)
+    {
+        flops += (n - i - 1)*(2.0*(width - i - 1) + 1) + 2.0*(n - i);//updates with multipliers, then row i of U
+    }
+    return flops;
+}
+
+void trafficReset()
+{
+    memset(trafficSlots, 0, sizeof(trafficSlots));
+}
+
+//bytes moved per socket in time seconds, printed and logged, returns the bytes of all sockets
+unsigned long long trafficReport(double time)
+{
+    unsigned long long total = 0;
+    int sockets = hostTopology().sockets;
+    int threads = profileThreads.load();
+    for (int s = 0; s < sockets; s++)
+    {
+        unsigned long long bytes = 0;
+        int active = 0;
+        for (int t = 0; t < threads; t++)
+        {
+            if(trafficSlots[t].bytes > 0 && trafficSlots[t].socket == s)
+            {
+                bytes += trafficSlots[t].bytes;
+                active++;
+            }
+        }
+        if(active == 0)
+        {
+            continue;
+        }
+        double rate = bytes/max(time, 1e-9)*1e-9;
+        cout<<"Socket "<<s<<": "<<active<<" threads, "<<bytes*1e-9<<" GB moved, "<<rate<<" GB/s"<<endl;
+        dataLogger += "socket ";
+        dataLogger += to_string(s);
+        dataLogger += ": ";
+        dataLogger += to_string(active);
+        dataLogger += " threads, ";
+        dataLogger += to_string(rate);
+        dataLogger += " GB/s, ";
+        total += bytes;
+    }
+    trafficReset();
+    return total;
+}
+
+const int matrixAlignment = 64;//byte alignment of the matrix buffer and of every row
+
+enum csvLayout{
+    layoutAugmented,//height on the first line, height+1 values per row - read by option 4
+    layoutBlock,//height on the first line, width taken from the first row - right-hand sides
+    layoutResult//width on the first line, one row per line - written by mPrint
+};
+
+//header of the binary matrix file, the data block starts right behind it, so mapped rows stay aligned
+struct binaryHeader{
+    char magic[4];//GEMB
+    int version;
+    int scalarSize;//4 for float, 8 for double
+    int height;
+    int width;
+    int ld;//leading dimension of the stored rows in elements
+    int alignment;//alignment of the data block and of every row in bytes
+    int layout;//csvLayout used when the file is converted back to text
+    int hasPermutation;//height ints of the row permutation follow the data block
+    int reserved;
+    unsigned long long checksum;//of the data block and the permutation, see fileChecksum
+    char padding[16];
+};
+
+static_assert(sizeof(binaryHeader) == matrixAlignment, "binary header must keep the data block aligned");
+
+const int binaryVersion = 1;
+const size_t checksumBlock = 1 << 20;//bytes hashed independently of each other
+const size_t csvWriteBatch = 64 << 20;//bytes of text formatted in memory before they are written
+
+//FNV-1a over 64-bit words of every checksumBlock bytes, the block hashes are combined in order,
+//so the blocks can be hashed in parallel
+unsigned long long dataChecksum(const char* block, size_t bytes)
+{
+    const unsigned long long prime = 1099511628211ULL;
+    const unsigned long long offset = 14695981039346656037ULL;
+    long long blocks = (bytes + checksumBlock - 1)/checksumBlock;
+    vector<unsigned long long> blockHash(blocks);
+
+    #pragma omp parallel for schedule(static)
+    for (long long b = 0; b < blocks; b++)
+    {
+        const char* begin = block + (size_t)b*checksumBlock;
+        size_t length = min(checksumBlock, bytes - (size_t)b*checksumBlock);
+        unsigned long long hash = offset;
+        size_t k = 0;
+        for (; k + 8 <= length; k += 8)
+        {
+            unsigned long long word;
+            memcpy(&word, begin + k, 8);
+            hash = (hash ^ word)*prime;
+        }
+        for (; k < length; k++)
+        {
+            hash = (hash ^ (unsigned char)begin[k])*prime;
+        }
+        blockHash[b] = hash;
+    }
+
+    unsigned long long hash = offset;
+    for (long long b = 0; b < blocks; b++)
+    {
+        hash = (hash ^ blockHash[b])*prime;
+    }
+    return hash;
+}
+
+//checksum of a binary file - the hash of the data block, combined with the hash of the permutation when it is stored
+unsigned long long fileChecksum(const char* block, size_t bytes, const int* perm, int height)
+{
+    unsigned long long hash = dataChecksum(block, bytes);
+    if(perm != NULL)
+    {
+        hash = (hash ^ dataChecksum((const char*)perm, (size_t)height*sizeof(int)))*1099511628211ULL;
+    }
+    return hash;
+}
+
+//true when perm holds every index 0..height-1 exactly once
+bool validPermutation(const int* perm, int height)
+{
+    vector<char> seen(height, 0);
+    for (int i = 0; i < height; i++)
+    {
+        if(perm[i] < 0 || perm[i] >= height || seen[perm[i]])
+        {
+            return false;
+        }
+        seen[perm[i]] = 1;
+    }
+    return true;
+}
+
+const int workspaceBuffers = 16;//released buffers kept for reuse
+const size_t workspaceBytes = (size_t)1 << 30;//limit of the bytes kept
+
+//buffers of released matrices and scratch arrays are kept here and handed to the next request of the same byte
+//size, so repeated solves of one size - menu runs, batch systems, benchmark trials - allocate nothing after the
+//first one; the oldest buffers are freed when the limits are reached
+class storageWorkspace
+{
+public:
+    size_t allocations;//buffers that had to come from the heap
+
+    storageWorkspace(){ count = 0; kept = 0; allocations = 0; }
+    ~storageWorkspace();
+    void* take(size_t bytes);//aligned buffer of bytes (a multiple of matrixAlignment)
+    void give(void* buffer, size_t bytes);
+
+private:
+    struct entry{
+        void* buffer;
+        size_t bytes;
+    };
+    entry entries[workspaceBuffers];
+    int count;
+    size_t kept;
+    mutex guard;
+
+    void evict();
+};
+
+storageWorkspace::~storageWorkspace()
+{
+    while(count > 0)
+    {
+        evict();
+    }
+}
+
+void storageWorkspace::evict()//frees the oldest buffer
+{
+    free(entries[0].buffer);
+    kept -= entries[0].bytes;
+    count--;
+    memmove(entries, entries + 1, count*sizeof(entry));
+}
+
+void* storageWorkspace::take(size_t bytes)
+{
+    {
+        lock_guard<mutex> lock(guard);
+        for (int e = count - 1; e >= 0; e--)//the most recently released buffer is the likeliest one in cache
+        {
+            if(entries[e].bytes == bytes)
+            {
+                void* buffer = entries[e].buffer;
+                kept -= bytes;
+                count--;
+                memmove(entries + e, entries + e + 1, (count - e)*sizeof(entry));
+                return buffer;
+            }
+        }
+        allocations++;
+    }
+    return aligned_alloc(matrixAlignment, bytes);
+}
+
+void storageWorkspace::give(void* buffer, size_t bytes)
+{
+    if(buffer == NULL)
+    {
+        return;
+    }
+    if(bytes > workspaceBytes)
+    {
+        free(buffer);
+        return;
+    }
+    lock_guard<mutex> lock(guard);
+    while(count == workspaceBuffers || kept + bytes > workspaceBytes)
+    {
+        evict();
+    }
+    entries[count].buffer = buffer;
+    entries[count].bytes = bytes;
+    count++;
+    kept += bytes;
+}
+
+static storageWorkspace workspace;
+
+//bytes rounded up to whole alignment units, as aligned_alloc requires
+inline size_t workspaceRound(size_t bytes)
+{
+    return max((size_t)matrixAlignment, (bytes + matrixAlignment - 1)/matrixAlignment*matrixAlignment);
+}
+
+//scratch array of count elements taken from the workspace for the lifetime of the object, not initialized
+template <typename U>
+struct workspaceArray{
+    U* data;
+    size_t bytes;
+
+    explicit workspaceArray(size_t count){ bytes = workspaceRound(count*sizeof(U)); data = (U*)workspace.take(bytes); }
+    ~workspaceArray(){ workspace.give(data, bytes); }
+    workspaceArray(const workspaceArray&) = delete;
+    workspaceArray& operator=(const workspaceArray&) = delete;
+    U& operator[](size_t i){ return data[i]; }
+    const U& operator[](size_t i) const { return data[i]; }
+};
+
+//matrix of a given scalar type (float or double)
+template <typename T>
+class cMatrixT
+{
+public:
+    int width;
+    int height;
+    int ld;//leading dimension - padded length of a stored row in elements
+    T* data;//one contiguous, aligned, row-major buffer of height*ld elements
+    int* perm;//row permutation - logical row i is kept in physical row perm[i]
+    double timeSeq, timePar;
+    bool errorFlag;
+
+    cMatrixT(int w, int h);//default constructor, sets all elements to 0
+    cMatrixT(string sourceName, csvLayout layout = layoutAugmented);//reading constructor for .csv and binary files
+    cMatrixT(const cMatrixT& source);//copy constructor
+    cMatrixT(cMatrixT&& source) noexcept;//move constructor, takes over the storage
+    cMatrixT& operator=(cMatrixT&& source) noexcept;
+    cMatrixT& operator=(const cMatrixT& source) = delete;//copies are made explicitly with the copy constructor
+    template <typename S> explicit cMatrixT(const cMatrixT<S>& source);//converting copy constructor, keeps the row order
+    ~cMatrixT();
+    void mPrint(string name);//print the elements to the file
+    void screenPrint();//print the elements to the screen
+    bool csvWrite(string fileName, csvLayout layout);//writes the matrix as text in a given layout
+    bool binaryWrite(string fileName, csvLayout layout, bool withPermutation = false);//writes the binary format
+
+    T* row(int i){ return data + (size_t)perm[i]*ld; }//logical row access
+    const T* row(int i) const { return data + (size_t)perm[i]*ld; }
+    void swapRows(int i, int j){ int t = perm[i]; perm[i] = perm[j]; perm[j] = t; }//O(1) row exchange
+
+private:
+    void* mapping;//memory mapped binary file the data points into, NULL for owned storage
+    size_t mappingSize;
+
+    void allocate(int w, int h, bool zero = true);//allocates storage, zeroed unless the caller fills it, and the identity permutation
+    void release();
+    void readCsv(const char* text, size_t fileSize, csvLayout layout);
+    void readBinary(int sourceFile, size_t fileSize);
+};
+
+typedef cMatrixT<float> cMatrix;
+typedef cMatrixT<double> cMatrixD;
+
+template <typename T>
+void cMatrixT<T>::allocate(int w, int h, bool zero)
+{
+    const int rowPadding = matrixAlignment/sizeof(T);//row length is rounded up to this number of elements
+    width = w;
+    height = h;
+    ld = ((width + rowPadding - 1)/rowPadding)*rowPadding;
+    size_t bytes = workspaceRound((size_t)height*ld*sizeof(T));
+    data = (T*)workspace.take(bytes);
+    if(zero)//rows are first touched by the threads that work on them, so their pages land on those threads' nodes
+    {
+        #pragma omp parallel for schedule(static) if(bytes >= firstTouchBytes)
+        for (int i = 0; i < height; i++)
+        {
+            memset(data + (size_t)i*ld, 0, (size_t)ld*sizeof(T));
+        }
+    }
+    mapping = NULL;
+    mappingSize = 0;
+    perm = (int*)workspace.take(workspaceRound(height*sizeof(int)));
+    for (int i = 0; i < height; i++)
+    {
+        perm[i] = i;
+    }
+}
+
+template <typename T>
+void cMatrixT<T>::release()
+{
+    if(mapping != NULL)
+    {
+        munmap(mapping, mappingSize);
+        mapping = NULL;
+    }
+    else if(data != NULL)
+    {
+        workspace.give(data, workspaceRound((size_t)height*ld*sizeof(T)));
+    }
+    if(perm != NULL)
+    {
+        workspace.give(perm, workspaceRound(height*sizeof(int)));
+    }
+    data = NULL;
+    perm = NULL;
+}
+
+template <typename T>
+cMatrixT<T>::cMatrixT(int w, int h)//default constructor
+{
+    timePar = 0;
+    timeSeq = 0;
+    errorFlag = false;
+    allocate(w, h);
+}
+
+template <typename T>
+cMatrixT<T>::cMatrixT(const cMatrixT& source)//copy constructor
+{
+    timePar = source.timePar;
+    timeSeq = source.timeSeq;
+    errorFlag = source.errorFlag;
+    allocate(source.width, source.height, false);
+    #pragma omp parallel for schedule(static) if((size_t)height*ld*sizeof(T) >= firstTouchBytes)
+    for (int i = 0; i < height; i++)
+    {
+        memcpy(data + (size_t)i*ld, source.data + (size_t)i*ld, (size_t)ld*sizeof(T));
+    }
+    memcpy(perm, source.perm, height*sizeof(int));
+}
+
+template <typename T>
+cMatrixT<T>::cMatrixT(cMatrixT&& source) noexcept//move constructor
+{
+    width = source.width;
+    height = source.height;
+    ld = source.ld;
+    data = source.data;
+    perm = source.perm;
+    timeSeq = source.timeSeq;
+    timePar = source.timePar;
+    errorFlag = source.errorFlag;
+    mapping = source.mapping;
+    mappingSize = source.mappingSize;
+    source.data = NULL;
+    source.perm = NULL;
+    source.mapping = NULL;
+}
+
+template <typename T>
+cMatrixT<T>& cMatrixT<T>::operator=(cMatrixT&& source) noexcept//move assignment, the old storage goes back to the workspace
+{
+    if(this != &source)
+    {
+        release();
+        width = source.width;
+        height = source.height;
+        ld = source.ld;
+        data = source.data;
+        perm = source.perm;
+        timeSeq = source.timeSeq;
+        timePar = source.timePar;
+        errorFlag = source.errorFlag;
+        mapping = source.mapping;
+        mappingSize = source.mappingSize;
+        source.data = NULL;
+        source.perm = NULL;
+        source.mapping = NULL;
+    }
+    return *this;
+}
+
+template <typename T>
+template <typename S>
+cMatrixT<T>::cMatrixT(const cMatrixT<S>& source)//converting copy constructor
+{
+    timePar = source.timePar;
+    timeSeq = source.timeSeq;
+    errorFlag = source.errorFlag;
+    allocate(source.width, source.height, false);
+    memcpy(perm, source.perm, height*sizeof(int));
+    #pragma omp parallel for schedule(static) if((size_t)height*ld*sizeof(T) >= firstTouchBytes)
+    for (int i = 0; i < height; i++)
+    {
+        const S* sourceRow = source.row(i);
+        T* rowI = row(i);
+        for (int j = 0; j < width; j++)
+        {
+            rowI[j] = (T)sourceRow[j];
+        }
+    }
+}
+
+//parses one value the way atof does: leading blanks and '+' are skipped, an unreadable field gives 0
+template <typename T>
+const char* parseValue(const char* p, const char* end, T* value)
+{
+    while(p < end && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+    if(p < end && *p == '+')
+    {
+        p++;
+    }
+    from_chars_result parsed = from_chars(p, end, *value);
+    if(parsed.ec != errc())
+    {
+        *value = 0;
+    }
+    return parsed.ptr;
+}
+
+template <typename T>
+cMatrixT<T>::cMatrixT(string sourceName, csvLayout layout)//file copy constructor
+{
+    errorFlag = false;
+    timePar = 0;
+    timeSeq = 0;
+    data = NULL;
+    perm = NULL;
+    mapping = NULL;
+
+    if(!silentMode)
+    {
+        dataLogger += endOfLine;
+        dataLogger += "Reading file: ";
+        dataLogger += sourceName;
+        dataLogger += "...";
+        dataLogger += "time: ";
+        dataLogger += currentDateTime();
+        dataLogger += "...";
+    }
+
+    double time = omp_get_wtime();
+    profileMark start = profileClock();
+
+    int sourceFile = open(sourceName.c_str(), O_RDONLY);
+    struct stat fileInfo;
+    if (sourceFile < 0 || fstat(sourceFile, &fileInfo) != 0){
+        if(!silentMode)
+        {
+            cout<<"Cannot open files."<<endl;
+            dataLogger += "Cannot open files.";
+        }
+        if(sourceFile >= 0)
+        {
+            close(sourceFile);
+        }
+        errorFlag = true;
+        allocate(1, 1);
+        return;
+    }
+
+    size_t fileSize = fileInfo.st_size;
+    char magic[4] = { 0, 0, 0, 0 };
+    if(pread(sourceFile, magic, 4, 0) == 4 && memcmp(magic, "GEMB", 4) == 0)
+    {
+        readBinary(sourceFile, fileSize);
+        close(sourceFile);
+    }
+    else
+    {
+        //the text is mapped into memory and parsed in place, without intermediate strings
+        const char* text = NULL;
+        if(fileSize > 0)
+        {
+            void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, sourceFile, 0);
+            if(mapped != MAP_FAILED)
+            {
+                text = (const char*)mapped;
+                madvise(mapped, fileSize, MADV_SEQUENTIAL);
+            }
+        }
+        close(sourceFile);
+        readCsv(text, fileSize, layout);
+        if(text != NULL)
+        {
+            munmap((void*)text, fileSize);
+        }
+    }
+
+    if(errorFlag){
+        if(!silentMode)
+        {
+            cout<<"Cannot read files."<<endl;
+            dataLogger += "Cannot read files.";
+        }
+        release();
+        allocate(1, 1);
+        return;
+    }
+
+    time = omp_get_wtime() - time;
+    profileAdd(phaseLoad, start);
+    double throughput = fileSize/(1e6*max(time, 1e-9));
+
+    if(!silentMode)
+    {
+        dataLogger += " OK, ";
+        dataLogger += to_string(throughput);
+        dataLogger += " MB/s";
+        cout<<"File reading: OK ("<<throughput<<" MB/s)"<<endl;
+    }
+}
+
+//parses the mapped text, sets errorFlag and leaves no storage behind on failure
+template <typename T>
+void cMatrixT<T>::readCsv(const char* text, size_t fileSize, csvLayout layout)
+{
+    const char* end = text + fileSize;
+
+    //first line - height of the matrix, or its width for the result layout
+    int firstValue = 0;
+    const char* p = text;
+    while(p != NULL && p < end && isspace((unsigned char)*p))
+    {
+        p++;
+    }
+    if(text == NULL || from_chars(p, end, firstValue).ec != errc() || firstValue < 1){
+        errorFlag = true;
+        return;
+    }
+
+    //row boundaries - the line after the first value is the first row
+    vector<const char*> lineStart;
+    p = (const char*)memchr(p, '\n', end - p);
+    while(p != NULL && p + 1 < end && (layout == layoutResult || (int)lineStart.size() < firstValue))
+    {
+        p++;
+        const char* next = (const char*)memchr(p, '\n', end - p);
+        const char* lineEnd = (next != NULL) ? next : end;
+        bool blank = true;//the result layout ends with an empty line
+        for (const char* c = p; c < lineEnd && blank; c++)
+        {
+            blank = isspace((unsigned char)*c);
+        }
+        if(!blank || layout != layoutResult)
+        {
+            lineStart.push_back(p);
+        }
+        p = next;
+    }
+    int rows = lineStart.size();
+    lineStart.push_back((p != NULL) ? p : end);
+
+    int h = (layout == layoutResult) ? rows : firstValue;
+    if(rows < h || h < 1){
+        errorFlag = true;
+        return;
+    }
+
+    int w = firstValue + 1;
+    if(layout == layoutBlock)//width of a block of right-hand sides is the number of values in its first row
+    {
+        w = count(lineStart[0], lineStart[1], ';') + 1;
+    }
+    else if(layout == layoutResult)
+    {
+        w = firstValue;
+    }
+    allocate(w, h);
+
+    #pragma omp parallel for schedule(static) num_threads(parameters.wantedThreads)
+    for (int i = 0; i < height; i++)
+    {
+        T* rowI = row(i);
+        const char* field = lineStart[i];
+        const char* lineEnd = lineStart[i + 1];
+        for (int j = 0; j < width; j++)
+        {
+            if(field >= lineEnd)//missing values are read as 0
+            {
+                rowI[j] = 0;
+                continue;
+            }
+            const char* next = (const char*)memchr(field, ';', lineEnd - field);
+            const char* fieldEnd = (next != NULL) ? next : lineEnd;
+            parseValue(field, fieldEnd, rowI + j);
+            field = (next != NULL) ? next + 1 : lineEnd;
+        }
+    }
+}
+
+//maps a binary file; when its scalar type and row alignment match, the rows are used in place -
+//the private mapping is copy-on-write, so the file never changes and untouched pages are never copied
+template <typename T>
+void cMatrixT<T>::readBinary(int sourceFile, size_t fileSize)
+{
+    binaryHeader header;
+    if(pread(sourceFile, &header, sizeof(header), 0) != (ssize_t)sizeof(header) || memcmp(header.magic, "GEMB", 4) != 0
+        || header.version != binaryVersion || (header.scalarSize != sizeof(float) && header.scalarSize != sizeof(double))
+        || header.height < 1 || header.width < 1 || header.ld < header.width
+        || header.alignment < 1 || (header.alignment & (header.alignment - 1)) != 0
+        || header.layout < layoutAugmented || header.layout > layoutResult){
+        errorFlag = true;
+        return;
+    }
+
+    size_t dataBytes = (size_t)header.height*header.ld*header.scalarSize;
+    size_t needed = sizeof(header) + dataBytes + (header.hasPermutation ? (size_t)header.height*sizeof(int) : 0);
+    if(fileSize < needed){
+        errorFlag = true;
+        return;
+    }
+
+    void* mapped = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, sourceFile, 0);
+    if(mapped == MAP_FAILED){
+        errorFlag = true;
+        return;
+    }
+    const char* block = (const char*)mapped + sizeof(header);
+    const int* storedPerm = header.hasPermutation ? (const int*)(block + dataBytes) : NULL;
+    if(fileChecksum(block, dataBytes, storedPerm, header.height) != header.checksum){
+        if(!silentMode)
+        {
+            cout<<"Checksum mismatch."<<endl;
+            dataLogger += "Checksum mismatch. ";
+        }
+        munmap(mapped, fileSize);
+        errorFlag = true;
+        return;
+    }
+    if(storedPerm != NULL && !validPermutation(storedPerm, header.height)){//rows are reached through it in every engine
+        munmap(mapped, fileSize);
+        errorFlag = true;
+        return;
+    }
+
+    if(header.scalarSize == sizeof(T) && header.alignment % matrixAlignment == 0 && ((size_t)header.ld*sizeof(T)) % matrixAlignment == 0)
+    {
+        width = header.width;
+        height = header.height;
+        ld = header.ld;
+        data = (T*)block;
+        mapping = mapped;
+        mappingSize = fileSize;
+        perm = (int*)workspace.take(workspaceRound(height*sizeof(int)));
+        for (int i = 0; i < height; i++)
+        {
+            perm[i] = i;
+        }
+    }
+    else//other scalar type or padding - the values are converted into own storage
+    {
+        allocate(header.width, header.height);
+        for (int i = 0; i < height; i++)
+        {
+            T* rowI = data + (size_t)i*ld;
+            for (int j = 0; j < width; j++)
+            {
+                size_t element = (size_t)i*header.ld + j;
+                rowI[j] = (header.scalarSize == sizeof(float)) ? (T)((const float*)block)[element]
+                    : (T)((const double*)block)[element];
+            }
+        }
+    }
+
+    if(storedPerm != NULL)
+    {
+        memcpy(perm, storedPerm, (size_t)height*sizeof(int));
+    }
+    if(mapping == NULL)
+    {
+        munmap(mapped, fileSize);
+    }
+}
+
+template <typename T>
+cMatrixT<T>::~cMatrixT()//destructor deallocates memory
+{
+    release();
+}
+
+template <typename T>
+void cMatrixT<T>::screenPrint()//printing to screen
+{
+    using namespace std;
+
+    //the screen is flushed once, not after every row
+    for (int i = 0; i < height; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            cout<<row(i)[j]<<"\t";
+        }
+        cout<<'\n';
+    }
+    cout<<endl;
+}
+
+template <typename T>
+void cMatrixT<T>::mPrint(string name)//printing to file
+{
+    using namespace std;
+
+    errorFlag = false;
+
+    string outputName = name;
+    outputName += "_";
+    outputName += to_string(timeSeq);
+    outputName += "_";
+    outputName += to_string(timePar);
+    outputName += ".csv";
+
+    dataLogger += endOfLine;
+    dataLogger += "File writing... ";
+    dataLogger += outputName;
+
+    dataLogger += "...time: ";
+    dataLogger += currentDateTime();
+    dataLogger += "...";
+
+    if(!csvWrite(outputName, layoutResult))
+    {
+        dataLogger += "Cannot write files.";
+        return;
+    }
+    dataLogger += " OK";
+}
+
+//appends a value to a text buffer, growing it when needed
+template <typename T>
+void appendValue(string& buffer, size_t& used, T value, chars_format format, int digits)
+{
+    to_chars_result written = to_chars(&buffer[used], &buffer[0] + buffer.size(), value, format, digits);
+    while(written.ec != errc())
+    {
+        buffer.resize(2*buffer.size() + 64);
+        written = to_chars(&buffer[used], &buffer[0] + buffer.size(), value, format, digits);
+    }
+    used = written.ptr - &buffer[0];
+}
+
+//text is formatted with to_chars (the same digits as fixed/setprecision) in per-thread buffers, a batch of rows
+//at a time, and every batch goes to the file in one call per thread buffer
+template <typename T>
+bool cMatrixT<T>::csvWrite(string fileName, csvLayout layout)
+{
+    using namespace std;
+    profileMark start = profileClock();
+
+    ofstream resultFile;
+    resultFile.open (fileName, ios::binary);
+    if (!resultFile.is_open()){
+        cout<<"Cannot open files."<<endl;
+        errorFlag = true;
+        return false;
+    }
+
+    string header = to_string((layout == layoutResult) ? width : height);
+    header += '\n';
+    resultFile.write(header.data(), header.size());
+
+    const int digits = numeric_limits<T>::digits10;
+    int threads = max(1, min(parameters.wantedThreads, height));
+    size_t rowEstimate = (size_t)width*(digits + 5) + 1;
+    int batchRows = max(threads, (int)min((size_t)height, csvWriteBatch/rowEstimate));
+    vector<string> buffers(threads);//kept between batches
+    vector<size_t> usedBytes(threads);
+
+    for (int b0 = 0; b0 < height; b0 += batchRows)
+    {
+        int b1 = min(b0 + batchRows, height);
+        #pragma omp parallel for schedule(static, 1) num_threads(threads)
+        for (int t = 0; t < threads; t++)
+        {
+            int begin = b0 + (int)((long long)(b1 - b0)*t/threads);
+            int end = b0 + (int)((long long)(b1 - b0)*(t + 1)/threads);
+            string& buffer = buffers[t];
+            size_t used = 0;
+            buffer.resize(max(buffer.size(), (size_t)(end - begin)*rowEstimate + 64));
+            for (int i = begin; i < end; i++)
+            {
+                const T* rowI = row(i);
+                for (int j = 0; j < width; j++)
+                {
+                    appendValue(buffer, used, rowI[j], chars_format::fixed, digits);
+                    if(used + 2 > buffer.size())
+                    {
+                        buffer.resize(2*buffer.size());
+                    }
+                    buffer[used++] = (j < (width - 1)) ? ';' : '\n';
+                }
+            }
+            usedBytes[t] = used;
+        }
+        for (int t = 0; t < threads; t++)
+        {
+            resultFile.write(buffers[t].data(), usedBytes[t]);
+        }
+    }
+
+    if(layout == layoutResult)
+    {
+        resultFile.write("\n", 1);
+    }
+    resultFile.close();
+    profileAdd(phaseStore, start);
+    return !resultFile.fail();
+}
+
+//rows are written in physical order when the permutation is stored with them, in logical order otherwise
+template <typename T>
+bool cMatrixT<T>::binaryWrite(string fileName, csvLayout layout, bool withPermutation)
+{
+    using namespace std;
+    profileMark start = profileClock();
+
+    size_t dataBytes = (size_t)height*ld*sizeof(T);
+    bool identity = true;
+    for (int i = 0; i < height && identity; i++)
+    {
+        identity = (perm[i] == i);
+    }
+
+    T* ordered = data;
+    if(!withPermutation && !identity)
+    {
+        ordered = (T*)workspace.take(dataBytes);
+        for (int i = 0; i < height; i++)
+        {
+            memcpy(ordered + (size_t)i*ld, row(i), (size_t)ld*sizeof(T));
+        }
+    }
+
+    binaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "GEMB", 4);
+    header.version = binaryVersion;
+    header.scalarSize = sizeof(T);
+    header.height = height;
+    header.width = width;
+    header.ld = ld;
+    header.alignment = matrixAlignment;
+    header.layout = layout;
+    header.hasPermutation = withPermutation;
+    header.checksum = fileChecksum((const char*)ordered, dataBytes, withPermutation ? perm : NULL, height);
+
+    bool written = false;
+    ofstream resultFile(fileName, ios::binary);
+    if(resultFile.is_open())
+    {
+        resultFile.write((const char*)&header, sizeof(header));
+        resultFile.write((const char*)ordered, dataBytes);
+        if(withPermutation)
+        {
+            resultFile.write((const char*)perm, (size_t)height*sizeof(int));
+        }
+        resultFile.close();
+        written = !resultFile.fail();
+    }
+    if(ordered != data)
+    {
+        workspace.give(ordered, dataBytes);
+    }
+    profileAdd(phaseStore, start);
+    if(!written)
+    {
+        cout<<"Cannot write files."<<endl;
+        errorFlag = true;
+        return false;
+    }
+    return true;
+}
+
+void updateDataLog()//printing data log to file and clearing it
+{
+    using namespace std;
+    ofstream resultFile;
+    string outputName = "DataLog.txt";
+    resultFile.open (outputName,std::ofstream::app);
+    if (resultFile.is_open())
+    {
+        resultFile<<endl;
+        resultFile<<dataLogger;
+        resultFile.close();
+    }
+    else
+        cout << "Unable to open file";
+    dataLogger = "";
+}
+
+void readDataLog()//reading data log file and printing it to the screen
+{
+    using namespace std;
+    string line = "";
+    string name = "DataLog.txt";
+    ifstream dataFile;
+
+    dataFile.open(name);
+
+    if (!dataFile.is_open()){
+        cout<<"Cannot open data files."<<endl;
+        return;
+    }
+    if(dataFile.fail()){
+        cout<<"Cannot read files."<<endl;
+    }
+    do
+    {
+        cout<<line;
+        getline(dataFile, line);//gets line from a file
+        cout<<endl;//prints it to the screen
+    }while(!dataFile.fail());
+}
+
+//changes options of parallel tasks
+void parallelOptionChange()
+{
+    int optionChosen;//chosen option
+
+    dataLogger += endOfLine;
+    dataLogger += "Changing parallel options: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", ";
+
+    do{
+        cout<<"*******************************"<<endl;
+        cout<<"Choose 1 to set a static scheduling:"<<endl;
+        cout<<"Choose 2 to set a dynamic scheduling:"<<endl;
+        cout<<"Choose 3 to set a guided scheduling:"<<endl;
+        cout<<"Choose 4 to set an auto scheduling:"<<endl;
+        cout<<"Choose 5 to set a task graph scheduling (tiled, with lookahead):"<<endl;
+        cout<<"Choose 6 to use the autotuned options of the tuning cache:"<<endl;
+
+        cin.clear();
+        cin.ignore(10000,'\n');
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if (optionChosen==1)
+        {
+            parameters.scheduleType = omp_sched_static;
+            parameters.taskGraph = false;
+            break;
+        }
+        else if (optionChosen==2)
+        {
+            parameters.scheduleType = omp_sched_dynamic;
+            parameters.taskGraph = false;
+            break;
+        }
+        else if (optionChosen==3)
+        {
+            parameters.scheduleType = omp_sched_guided;
+            parameters.taskGraph = false;
+            break;
+        }
+        else if (optionChosen==4)
+        {
+            parameters.scheduleType = omp_sched_auto;
+            parameters.taskGraph = false;
+            break;
+        }
+        else if (optionChosen==5)
+        {
+            parameters.scheduleType = omp_sched_dynamic;//used by the loops outside of the task graph
+            parameters.taskGraph = true;
+            break;
+        }
+        else if (optionChosen==6)
+        {
+            useTuning = true;
+            dataLogger += "autotuned options.";
+            return;
+        }
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+    }while(1);
+    useTuning = false;//options chosen by hand are used for every size
+
+    do{
+        cout<<"Choose size of chunks:"<<endl;
+        cin.clear();
+        cin.ignore(10000,'\n');
+
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if(sizeof(optionChosen)==sizeof(int))
+        {
+            parameters.chunkSize = optionChosen;
+            break;
+        }
+
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+
+    }while(1);
+
+    do{
+        cout<<"Choose a desired number of threads:"<<endl;
+        cin.clear();
+        cin.ignore(10000,'\n');
+
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if(sizeof(optionChosen)==sizeof(int))
+        {
+            parameters.wantedThreads = optionChosen;
+            break;
+        }
+
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+
+    }while(1);
+
+    do{
+        cout<<"Choose a block size (1 turns blocking off):"<<endl;
+        cin.clear();
+        cin.ignore(10000,'\n');
+
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if(optionChosen>0)
+        {
+            parameters.blockSize = optionChosen;
+            break;
+        }
+
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+
+    }while(1);
+
+    do{
+        cout<<"Choose a thread affinity (1 none, 2 compact, 3 spread over the sockets):"<<endl;
+        cin.clear();
+        cin.ignore(10000,'\n');
+
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if(optionChosen>=1 && optionChosen<=3)
+        {
+            parameters.affinity = (affinityPolicy)(optionChosen - 1);
+            break;
+        }
+
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+
+    }while(1);
+}
+
+//*************tuning cache*******************************
+
+struct tuningEntry{
+    string host;
+    int bucket;//largest amount of equations of the size class
+    parallelParam param;
+    double time;//median time of the winning configuration on the tuning system
+};
+
+//host identification of the cache entries - tuned parameters of one machine are not used on another
+string tuningHost()
+{
+    char name[256] = "unknown";
+    gethostname(name, sizeof(name) - 1);
+    return string(name) + "-" + to_string(omp_get_num_procs());
+}
+
+//size classes are powers of two
+int sizeBucket(int height)
+{
+    int bucket = 16;
+    while(bucket < height && bucket < (1 << 30))
+    {
+        bucket *= 2;
+    }
+    return bucket;
+}
+
+//one entry per line: host bucket schedule chunk threads block task time
+vector<tuningEntry> readTuningCache()
+{
+    vector<tuningEntry> entries;
+    ifstream cacheFile(tuningCacheName);
+    string line;
+    while(getline(cacheFile, line))
+    {
+        if(line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        stringstream fields(line);
+        tuningEntry entry;
+        int schedule = 0, task = 0;
+        fields>>entry.host>>entry.bucket>>schedule>>entry.param.chunkSize>>entry.param.wantedThreads>>entry.param.blockSize>>task>>entry.time;
+        if(fields.fail() || schedule < (int)omp_sched_static || schedule > (int)omp_sched_auto || entry.param.wantedThreads < 1 || entry.param.blockSize < 1)
+        {
+            continue;//damaged lines are skipped
+        }
+        entry.param.scheduleType = (omp_sched_t)schedule;
+        entry.param.taskGraph = (task != 0);
+        entry.param.affinity = affinityNone;//placement is not tuned, the caller's policy is kept
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+static vector<tuningEntry> tuningEntries;//the cache file as read by the first solve
+static bool tuningLoaded = false;//cleared when the file is written, so the next solve reads it again
+
+bool writeTuningCache(const vector<tuningEntry>& entries)
+{
+    tuningLoaded = false;
+    ofstream cacheFile(tuningCacheName);
+    cacheFile<<"# host bucket schedule chunk threads block task time"<<endOfLine;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        const tuningEntry& entry = entries[e];
+        cacheFile<<entry.host<<" "<<entry.bucket<<" "<<(int)entry.param.scheduleType<<" "<<entry.param.chunkSize<<" "
+            <<entry.param.wantedThreads<<" "<<entry.param.blockSize<<" "<<(int)entry.param.taskGraph<<" "<<entry.time<<endOfLine;
+    }
+    return (bool)cacheFile;
+}
+
+//parameters tuned on this host for the size class closest to height, false when nothing was tuned here
+bool tunedParameters(int height, parallelParam* tuned)
+{
+    if(!tuningLoaded)
+    {
+        tuningEntries = readTuningCache();
+        tuningLoaded = true;
+    }
+    const vector<tuningEntry>& entries = tuningEntries;
+    static string host = tuningHost();
+    double best = HUGE_VAL;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        double distance = abs(log2((double)entries[e].bucket) - log2((double)sizeBucket(height)));
+        if(entries[e].host == host && distance < best)
+        {
+            best = distance;
+            affinityPolicy affinity = tuned->affinity;
+            *tuned = entries[e].param;
+            tuned->affinity = affinity;
+        }
+    }
+    return best != HUGE_VAL;
+}
+
+//chooses how the structure of a system is found: measured, assumed dense, or given as a shape
+void structureOptionChange()
+{
+    int optionChosen;//chosen option
+
+    dataLogger += endOfLine;
+    dataLogger += "Changing structure hint: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", ";
+
+    do{
+        cout<<"*******************************"<<endl;
+        cout<<"Choose 1 to detect banded and triangular systems:"<<endl;
+        cout<<"Choose 2 to treat every system as dense:"<<endl;
+        cout<<"Choose 3 to solve every system as banded:"<<endl;
+        cout<<"Choose 4 to solve every system as upper triangular:"<<endl;
+        cout<<"Choose 5 to solve every system as lower triangular:"<<endl;
+        cout<<"Choose 6 to solve every system as tridiagonal:"<<endl;
+
+        cin.clear();
+        cin.ignore(10000,'\n');
+        cin>>optionChosen;
+
+        if(cin.fail() || optionChosen < 1 || optionChosen > 6){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+        break;
+    }while(1);
+
+    const char* names[] = { "detect", "dense", "banded", "upper triangular", "lower triangular", "tridiagonal" };
+    structureHint = (structureHintType)(optionChosen - 1);
+    dataLogger += names[optionChosen - 1];
+}
+
+//changes the scalar type used by the solver
+void precisionOptionChange()
+{
+    int optionChosen;//chosen option
+
+    dataLogger += endOfLine;
+    dataLogger += "Changing precision: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", ";
+
+    do{
+        cout<<"*******************************"<<endl;
+        cout<<"Choose 1 to solve in single precision (float):"<<endl;
+        cout<<"Choose 2 to solve in double precision (double):"<<endl;
+        cout<<"Choose 3 to factorize in float and refine the solution in double:"<<endl;
+
+        cin.clear();
+        cin.ignore(10000,'\n');
+        cin>>optionChosen;
+
+        if(cin.fail()){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+
+        if (optionChosen==1)
+        {
+            precision = precisionFloat;
+            dataLogger += "float";
+            break;
+        }
+        else if (optionChosen==2)
+        {
+            precision = precisionDouble;
+            dataLogger += "double";
+            break;
+        }
+        else if (optionChosen==3)
+        {
+            precision = precisionMixed;
+            dataLogger += "mixed";
+            break;
+        }
+        else
+        {
+            cout<<"Choose a correct value."<<endl;
+        }
+    }while(1);
+}
+
+//*************vector kernels*******************************
+//every kernel has a scalar version and x86 versions compiled for a given instruction set;
+//the widest set supported by the host is chosen once at startup
+
+template <typename T>
+void rowUpdateScalar(T* y, const T* x, T a, int n)//y = y - a*x
+{
+    for (int k = 0; k < n; k++)
+    {
+        y[k] -= a*x[k];
+    }
+}
+
+template <typename T>
+T dotScalar(const T* x, const T* y, int n)
+{
+    T sum = 0;
+    for (int k = 0; k < n; k++)
+    {
+        sum += x[k]*y[k];
+    }
+    return sum;
+}
+
+//index (counted from 0) of the largest |base[perm[j]*ld]| for j < n, the first one wins on ties
+template <typename T>
+int maxAbsScalar(const T* base, const int* perm, int ld, int n)
+{
+    int best = 0;
+    T bestValue = -1;
+    for (int j = 0; j < n; j++)
+    {
+        T value = abs(base[(size_t)perm[j]*ld]);
+        if(value > bestValue)
+        {
+            bestValue = value;
+            best = j;
+        }
+    }
+    return best;
+}
+
+#ifdef GAUSS_X86_KERNELS
+
+__attribute__((target("sse2")))
+void rowUpdateSse2(float* y, const float* x, float a, int n)
+{
+    __m128 va = _mm_set1_ps(a);
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        _mm_storeu_ps(y + k, _mm_sub_ps(_mm_loadu_ps(y + k), _mm_mul_ps(va, _mm_loadu_ps(x + k))));
+    }
+    for (; k < n; k++)
+    {
+        y[k] -= a*x[k];
+    }
+}
+
+__attribute__((target("sse2")))
+float dotSse2(const float* x, const float* y, int n)
+{
+    __m128 acc = _mm_setzero_ps();
+    int k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(y + k)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; k < n; k++)
+    {
+        sum += x[k]*y[k];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+void rowUpdateAvx2(float* y, const float* x, float a, int n)
+{
+    __m256 va = _mm256_set1_ps(a);
+    int k = 0;
+    for (; k + 16 <= n; k += 16)
+    {
+        __m256 y0 = _mm256_fnmadd_ps(va, _mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k));
+        __m256 y1 = _mm256_fnmadd_ps(va, _mm256_loadu_ps(x + k + 8), _mm256_loadu_ps(y + k + 8));
+        _mm256_storeu_ps(y + k, y0);
+        _mm256_storeu_ps(y + k + 8, y1);
+    }
+    for (; k + 8 <= n; k += 8)
+    {
+        _mm256_storeu_ps(y + k, _mm256_fnmadd_ps(va, _mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k)));
+    }
+    for (; k < n; k++)
+    {
+        y[k] -= a*x[k];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+float dotAvx2(const float* x, const float* y, int n)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int k = 0;
+    for (; k + 16 <= n; k += 16)
+    {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + k + 8), _mm256_loadu_ps(y + k + 8), acc1);
+    }
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    float sum = _mm_cvtss_f32(half);
+    for (; k < n; k++)
+    {
+        sum += x[k]*y[k];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+int maxAbsAvx2(const float* base, const int* perm, int ld, int n)
+{
+    if(n < 8)
+    {
+        return maxAbsScalar(base, perm, ld, n);
+    }
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256i vld = _mm256_set1_epi32(ld);
+    __m256 best = _mm256_set1_ps(-1.0f);
+    __m256i bestIndex = _mm256_setzero_si256();
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    int j = 0;
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(perm + j)), vld);
+        __m256 value = _mm256_andnot_ps(signMask, _mm256_i32gather_ps(base, offsets, 4));
+        __m256 greater = _mm256_cmp_ps(value, best, _CMP_GT_OQ);
+        best = _mm256_blendv_ps(best, value, greater);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(greater));
+        index = _mm256_add_epi32(index, step);
+    }
+    float values[8];
+    int indices[8];
+    _mm256_storeu_ps(values, best);
+    _mm256_storeu_si256((__m256i*)indices, bestIndex);
+    int result = indices[0];
+    float resultValue = values[0];
+    for (int l = 1; l < 8; l++)
+    {
+        if(values[l] > resultValue || (values[l] == resultValue && indices[l] < result))
+        {
+            resultValue = values[l];
+            result = indices[l];
+        }
+    }
+    for (; j < n; j++)
+    {
+        float value = abs(base[(size_t)perm[j]*ld]);
+        if(value > resultValue)
+        {
+            resultValue = value;
+            result = j;
+        }
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+void rowUpdateAvx512(float* y, const float* x, float a, int n)
+{
+    __m512 va = _mm512_set1_ps(a);
+    int k = 0;
+    for (; k + 16 <= n; k += 16)
+    {
+        _mm512_storeu_ps(y + k, _mm512_fnmadd_ps(va, _mm512_loadu_ps(x + k), _mm512_loadu_ps(y + k)));
+    }
+    if(k < n)
+    {
+        __mmask16 mask = (__mmask16)((1u << (n - k)) - 1);
+        __m512 tail = _mm512_fnmadd_ps(va, _mm512_maskz_loadu_ps(mask, x + k), _mm512_maskz_loadu_ps(mask, y + k));
+        _mm512_mask_storeu_ps(y + k, mask, tail);
+    }
+}
+
+__attribute__((target("avx512f")))
+float dotAvx512(const float* x, const float* y, int n)
+{
+    __m512 acc = _mm512_setzero_ps();
+    int k = 0;
+    for (; k + 16 <= n; k += 16)
+    {
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(x + k), _mm512_loadu_ps(y + k), acc);
+    }
+    if(k < n)
+    {
+        __mmask16 mask = (__mmask16)((1u << (n - k)) - 1);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + k), _mm512_maskz_loadu_ps(mask, y + k), acc);
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, acc);
+    float sum = 0;
+    for (int l = 0; l < 16; l++)
+    {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+int maxAbsAvx512(const float* base, const int* perm, int ld, int n)
+{
+    if(n < 16)
+    {
+        return maxAbsScalar(base, perm, ld, n);
+    }
+    const __m512i vld = _mm512_set1_epi32(ld);
+    __m512 best = _mm512_set1_ps(-1.0f);
+    __m512i bestIndex = _mm512_setzero_si512();
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i step = _mm512_set1_epi32(16);
+    int j = 0;
+    for (; j + 16 <= n; j += 16)
+    {
+        __m512i offsets = _mm512_mullo_epi32(_mm512_loadu_si512(perm + j), vld);
+        __m512 value = _mm512_abs_ps(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, offsets, base, 4));
+        __mmask16 greater = _mm512_cmp_ps_mask(value, best, _CMP_GT_OQ);
+        best = _mm512_mask_blend_ps(greater, best, value);
+        bestIndex = _mm512_mask_blend_epi32(greater, bestIndex, index);
+        index = _mm512_add_epi32(index, step);
+    }
+    float values[16];
+    int indices[16];
+    _mm512_storeu_ps(values, best);
+    _mm512_storeu_si512(indices, bestIndex);
+    int result = indices[0];
+    float resultValue = values[0];
+    for (int l = 1; l < 16; l++)
+    {
+        if(values[l] > resultValue || (values[l] == resultValue && indices[l] < result))
+        {
+            resultValue = values[l];
+            result = indices[l];
+        }
+    }
+    for (; j < n; j++)
+    {
+        float value = abs(base[(size_t)perm[j]*ld]);
+        if(value > resultValue)
+        {
+            resultValue = value;
+            result = j;
+        }
+    }
+    return result;
+}
+
+__attribute__((target("sse2")))
+void rowUpdateSse2Double(double* y, const double* x, double a, int n)
+{
+    __m128d va = _mm_set1_pd(a);
+    int k = 0;
+    for (; k + 2 <= n; k += 2)
+    {
+        _mm_storeu_pd(y + k, _mm_sub_pd(_mm_loadu_pd(y + k), _mm_mul_pd(va, _mm_loadu_pd(x + k))));
+    }
+    for (; k < n; k++)
+    {
+        y[k] -= a*x[k];
+    }
+}
+
+__attribute__((target("sse2")))
+double dotSse2Double(const double* x, const double* y, int n)
+{
+    __m128d acc = _mm_setzero_pd();
+    int k = 0;
+    for (; k + 2 <= n; k += 2)
+    {
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(x + k), _mm_loadu_pd(y + k)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, acc);
+    double sum = lanes[0] + lanes[1];
+    for (; k < n; k++)
+    {
+        sum += x[k]*y[k];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+void rowUpdateAvx2Double(double* y, const double* x, double a, int n)
+{
+    __m256d va = _mm256_set1_pd(a);
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        __m256d y0 = _mm256_fnmadd_pd(va, _mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k));
+        __m256d y1 = _mm256_fnmadd_pd(va, _mm256_loadu_pd(x + k + 4), _mm256_loadu_pd(y + k + 4));
+        _mm256_storeu_pd(y + k, y0);
+        _mm256_storeu_pd(y + k + 4, y1);
+    }
+    for (; k + 4 <= n; k += 4)
+    {
+        _mm256_storeu_pd(y + k, _mm256_fnmadd_pd(va, _mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k)));
+    }
+    for (; k < n; k++)
+    {
+        y[k] -= a*x[k];
+    }
+}
+
+__attribute__((target("avx2,fma")))
+double dotAvx2Double(const double* x, const double* y, int n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + k + 4), _mm256_loadu_pd(y + k + 4), acc1);
+    }
+    acc0 = _mm256_add_pd(acc0, acc1);
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+    half = _mm_add_sd(half, _mm_unpackhi_pd(half, half));
+    double sum = _mm_cvtsd_f64(half);
+    for (; k < n; k++)
+    {
+        sum += x[k]*y[k];
+    }
+    return sum;
+}
+
+//indices are carried in double lanes, exact for any int
+__attribute__((target("avx2")))
+int maxAbsAvx2Double(const double* base, const int* perm, int ld, int n)
+{
+    if(n < 4)
+    {
+        return maxAbsScalar(base, perm, ld, n);
+    }
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    const __m128i vld = _mm_set1_epi32(ld);
+    __m256d best = _mm256_set1_pd(-1.0);
+    __m256d bestIndex = _mm256_setzero_pd();
+    __m256d index = _mm256_setr_pd(0, 1, 2, 3);
+    const __m256d step = _mm256_set1_pd(4);
+    int j = 0;
+    for (; j + 4 <= n; j += 4)
+    {
+        __m128i offsets = _mm_mullo_epi32(_mm_loadu_si128((const __m128i*)(perm + j)), vld);
+        __m256d value = _mm256_andnot_pd(signMask, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, offsets, allLanes, 8));
+        __m256d greater = _mm256_cmp_pd(value, best, _CMP_GT_OQ);
+        best = _mm256_blendv_pd(best, value, greater);
+        bestIndex = _mm256_blendv_pd(bestIndex, index, greater);
+        index = _mm256_add_pd(index, step);
+    }
+    double values[4];
+    double indices[4];
+    _mm256_storeu_pd(values, best);
+    _mm256_storeu_pd(indices, bestIndex);
+    int result = (int)indices[0];
+    double resultValue = values[0];
+    for (int l = 1; l < 4; l++)
+    {
+        if(values[l] > resultValue || (values[l] == resultValue && (int)indices[l] < result))
+        {
+            resultValue = values[l];
+            result = (int)indices[l];
+        }
+    }
+    for (; j < n; j++)
+    {
+        double value = abs(base[(size_t)perm[j]*ld]);
+        if(value > resultValue)
+        {
+            resultValue = value;
+            result = j;
+        }
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+void rowUpdateAvx512Double(double* y, const double* x, double a, int n)
+{
+    __m512d va = _mm512_set1_pd(a);
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        _mm512_storeu_pd(y + k, _mm512_fnmadd_pd(va, _mm512_loadu_pd(x + k), _mm512_loadu_pd(y + k)));
+    }
+    if(k < n)
+    {
+        __mmask8 mask = (__mmask8)((1u << (n - k)) - 1);
+        __m512d tail = _mm512_fnmadd_pd(va, _mm512_maskz_loadu_pd(mask, x + k), _mm512_maskz_loadu_pd(mask, y + k));
+        _mm512_mask_storeu_pd(y + k, mask, tail);
+    }
+}
+
+__attribute__((target("avx512f")))
+double dotAvx512Double(const double* x, const double* y, int n)
+{
+    __m512d acc = _mm512_setzero_pd();
+    int k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(x + k), _mm512_loadu_pd(y + k), acc);
+    }
+    if(k < n)
+    {
+        __mmask8 mask = (__mmask8)((1u << (n - k)) - 1);
+        acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + k), _mm512_maskz_loadu_pd(mask, y + k), acc);
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, acc);
+    double sum = 0;
+    for (int l = 0; l < 8; l++)
+    {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+int maxAbsAvx512Double(const double* base, const int* perm, int ld, int n)
+{
+    if(n < 8)
+    {
+        return maxAbsScalar(base, perm, ld, n);
+    }
+    const __m256i vld = _mm256_set1_epi32(ld);
+    __m512d best = _mm512_set1_pd(-1.0);
+    __m512d bestIndex = _mm512_setzero_pd();
+    __m512d index = _mm512_setr_pd(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512d step = _mm512_set1_pd(8);
+    int j = 0;
+    for (; j + 8 <= n; j += 8)
+    {
+        __m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(perm + j)), vld);
+        __m512d value = _mm512_abs_pd(_mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, offsets, base, 8));
+        __mmask8 greater = _mm512_cmp_pd_mask(value, best, _CMP_GT_OQ);
+        best = _mm512_mask_blend_pd(greater, best, value);
+        bestIndex = _mm512_mask_blend_pd(greater, bestIndex, index);
+        index = _mm512_add_pd(index, step);
+    }
+    double values[8];
+    double indices[8];
+    _mm512_storeu_pd(values, best);
+    _mm512_storeu_pd(indices, bestIndex);
+    int result = (int)indices[0];
+    double resultValue = values[0];
+    for (int l = 1; l < 8; l++)
+    {
+        if(values[l] > resultValue || (values[l] == resultValue && (int)indices[l] < result))
+        {
+            resultValue = values[l];
+            result = (int)indices[l];
+        }
+    }
+    for (; j < n; j++)
+    {
+        double value = abs(base[(size_t)perm[j]*ld]);
+        if(value > resultValue)
+        {
+            resultValue = value;
+            result = j;
+        }
+    }
+    return result;
+}
+
+#endif
+
+enum kernelIsa{isaScalar, isaSse2, isaAvx2, isaAvx512};
+
+struct kernelSet{
+    void (*rowUpdate)(float* y, const float* x, float a, int n);
+    float (*dot)(const float* x, const float* y, int n);
+    int (*maxAbs)(const float* base, const int* perm, int ld, int n);
+    void (*rowUpdateDouble)(double* y, const double* x, double a, int n);
+    double (*dotDouble)(const double* x, const double* y, int n);
+    int (*maxAbsDouble)(const double* base, const int* perm, int ld, int n);
+    kernelIsa isa;//instruction set of the set, also used by engines that are compiled for each of them
+    const char* name;
+};
+
+//picks the widest instruction set supported by the host
+//GAUSS_KERNELS=scalar|sse2|avx2|avx512 can limit the choice, e.g. for comparisons
+kernelSet selectKernels()
+{
+    kernelSet set = { rowUpdateScalar<float>, dotScalar<float>, maxAbsScalar<float>,
+        rowUpdateScalar<double>, dotScalar<double>, maxAbsScalar<double>, isaScalar, "scalar" };
+#ifdef GAUSS_X86_KERNELS
+    const char* limit = getenv("GAUSS_KERNELS");
+    string wanted = limit ? limit : "avx512";
+    __builtin_cpu_init();
+    if(wanted == "scalar")
+    {
+        return set;
+    }
+    if(__builtin_cpu_supports("sse2"))
+    {
+        set = { rowUpdateSse2, dotSse2, maxAbsScalar<float>,
+            rowUpdateSse2Double, dotSse2Double, maxAbsScalar<double>, isaSse2, "sse2" };
+    }
+    if(wanted == "sse2")
+    {
+        return set;
+    }
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        set = { rowUpdateAvx2, dotAvx2, maxAbsAvx2,
+            rowUpdateAvx2Double, dotAvx2Double, maxAbsAvx2Double, isaAvx2, "avx2" };
+    }
+    if(wanted == "avx2")
+    {
+        return set;
+    }
+    if(__builtin_cpu_supports("avx512f"))
+    {
+        set = { rowUpdateAvx512, dotAvx512, maxAbsAvx512,
+            rowUpdateAvx512Double, dotAvx512Double, maxAbsAvx512Double, isaAvx512, "avx512" };
+    }
+#endif
+    return set;
+}
+
+static kernelSet kernels = selectKernels();
+
+//overloads picking the kernel of a scalar type, used by the templated engines
+inline void rowUpdate(float* y, const float* x, float a, int n){ kernels.rowUpdate(y, x, a, n); }
+inline void rowUpdate(double* y, const double* x, double a, int n){ kernels.rowUpdateDouble(y, x, a, n); }
+inline float dotProduct(const float* x, const float* y, int n){ return kernels.dot(x, y, n); }
+inline double dotProduct(const double* x, const double* y, int n){ return kernels.dotDouble(x, y, n); }
+inline int maxAbs(const float* base, const int* perm, int ld, int n){ return kernels.maxAbs(base, perm, ld, n); }
+inline int maxAbs(const double* base, const int* perm, int ld, int n){ return kernels.maxAbsDouble(base, perm, ld, n); }
+
+//index of the row with the largest |element| in column col among rows from..to-1
+//gathering kernels use 32-bit offsets, larger matrices fall back to the scalar search
+template <typename T>
+int pivotSearch(const cMatrixT<T>& m, int col, int from, int to)
+{
+    if(to <= from)
+    {
+        return from;
+    }
+    profileMark start = profileClock();
+    int maxIndex;
+    if((size_t)m.height*m.ld > INT_MAX)
+    {
+        maxIndex = from + maxAbsScalar(m.data + col, m.perm + from, m.ld, to - from);
+    }
+    else
+    {
+        maxIndex = from + maxAbs(m.data + col, m.perm + from, m.ld, to - from);
+    }
+    profileAdd(phasePivotSearch, start);
+    return maxIndex;
+}
+
+//pivot candidate of a column - threads combine theirs through the maxPivot reduction instead of a lock,
+//equal magnitudes go to the lower row, so the choice does not depend on the number of threads
+struct pivotCandidate{
+    double value;//|element|, -1 before any row was seen
+    int row;
+};
+
+const pivotCandidate noPivot = { -1, INT_MAX };
+
+inline pivotCandidate betterPivot(pivotCandidate a, pivotCandidate b)
+{
+    return (b.value > a.value || (b.value == a.value && b.row < a.row)) ? b : a;
+}
+
+#pragma omp declare reduction(maxPivot : pivotCandidate : omp_out = betterPivot(omp_out, omp_in)) initializer(omp_priv = noPivot)
+
+//candidate of column col in part part of parts equal parts of rows from..to-1
+template <typename T>
+pivotCandidate partPivot(const cMatrixT<T>& m, int col, int from, int to, int part, int parts)
+{
+    long long length = to - from;
+    int begin = from + (int)(length*part/parts);
+    int end = from + (int)(length*(part + 1)/parts);
+    if(begin >= end)
+    {
+        return noPivot;
+    }
+    int row = pivotSearch(m, col, begin, end);
+    return pivotCandidate{ (double)abs(m.row(row)[col]), row };
+}
+
+//unblocked elimination run inside one parallel region for all pivots
+//the row reduction of a step also finds the pivot of the next column in the rows it has just updated,
+//a separate search is only needed for the first column and after an omitted row
+//returns the number of omitted rows
+template <typename T>
+int parallelElimination(cMatrixT<T>& tmp2)
+{
+    int index = 0;
+    int n = tmp2.height;
+    pivotCandidate candidate = noPivot;//shared pivot of the current step
+
+    #pragma omp parallel shared(tmp2, index, candidate)
+    {
+        bool found = false;//the candidate came with the previous reduction, the same in every thread
+        for (int i = 0; i < n; i++)
+        {
+            if(!found)//searching for a maximum element
+            {
+                int parts = omp_get_num_threads();
+                #pragma omp for schedule(static) reduction(maxPivot : candidate)
+                for (int part = 0; part < parts; part++)
+                {
+                    candidate = betterPivot(candidate, partPivot(tmp2, i, i, n, part, parts));
+                }
+            }
+            #pragma omp barrier
+
+            #pragma omp single
+            {
+                if(candidate.row != i)//changing rows if needed - only the permutation entries are exchanged
+                {
+                    profileMark start = profileClock();
+                    tmp2.swapRows(i, candidate.row);
+                    profileAdd(phaseRowSwap, start);
+                }
+                if(tmp2.row(i)[i]==0)
+                {
+                    index++;
+                }
+                candidate = noPivot;//starting point of the next reduction
+            }
+
+            const T* rowI = tmp2.row(i);
+            found = (rowI[i] != 0);
+            if(!found){//rows with maximum element equal to 0 are omitted
+                continue;
+            }
+
+            T inverse = 1/rowI[i];
+            profileMark start = profileClock();
+            size_t moved = 0;//the pivot row stays in cache, every other row is read and written once
+            #pragma omp for schedule(runtime) nowait reduction(maxPivot : candidate)
+            for (int j = i + 1; j < n; j++)//reduction
+            {
+                T* rowJ = tmp2.row(j);
+                T multiplier = rowJ[i]*inverse;//hoisted, so the update below is a pure fused multiply-add
+                rowJ[i] = multiplier;//multipliers of L are kept below the diagonal
+                rowUpdate(rowJ + i + 1, rowI + i + 1, multiplier, tmp2.width - i - 1);
+                candidate = betterPivot(candidate, pivotCandidate{ (double)abs(rowJ[i + 1]), j });//still in cache
+                moved += 2*(size_t)(tmp2.width - i)*sizeof(T);
+            }
+            profileAdd(phaseTrailingUpdate, start);//the barrier is left out of the measured time
+            trafficAdd(moved);
+            #pragma omp barrier
+        }
+    }
+    return index;
+}
+
+//blocked right-looking LU factorization of the augmented matrix
+//a panel of blockSize columns is factored with partial pivoting, then the rows of U to its right are solved
+//and the trailing matrix is updated as a tiled matrix-matrix product; multipliers of L stay below the diagonal
+//the pivot of the next column is found by the panel update, or by the trailing update for the first column
+//of the next panel
+//the whole factorization runs in one parallel region
+//returns the number of omitted rows
+template <typename T>
+int blockedElimination(cMatrixT<T>& tmp, int blockSize)
+{
+    int index = 0;
+    int n = tmp.height;
+    pivotCandidate candidate = noPivot;//shared pivot of the current step
+
+    #pragma omp parallel shared(tmp, index, candidate)
+    {
+        bool found = false;//the candidate came with the previous reduction, the same in every thread
+        for (int k0 = 0; k0 < n; k0 += blockSize)
+        {
+            int k1 = min(k0 + blockSize, n);//first column behind the panel
+
+            //panel factorization
+            for (int i = k0; i < k1; i++)
+            {
+                if(!found)//searching for a maximum element
+                {
+                    int parts = omp_get_num_threads();
+                    #pragma omp for schedule(static) reduction(maxPivot : candidate)
+                    for (int part = 0; part < parts; part++)
+                    {
+                        candidate = betterPivot(candidate, partPivot(tmp, i, i, n, part, parts));
+                    }
+                }
+                #pragma omp barrier
+
+                #pragma omp single
+                {
+                    if(candidate.row != i)
+                    {
+                        profileMark start = profileClock();
+                        tmp.swapRows(i, candidate.row);
+                        profileAdd(phaseRowSwap, start);
+                    }
+                    if(tmp.row(i)[i]==0)
+                    {
+                        index++;
+                    }
+                    candidate = noPivot;//starting point of the next reduction
+                }
+
+                const T* rowI = tmp.row(i);
+                bool fused = (i + 1 < k1);//the next column is inside the panel
+                found = (rowI[i] != 0) && fused;
+                if(rowI[i]==0){//rows with maximum element equal to 0 are omitted
+                    continue;
+                }
+
+                T inverse = 1/rowI[i];
+                profileMark start = profileClock();
+                size_t moved = 0;
+                #pragma omp for schedule(runtime) nowait reduction(maxPivot : candidate)
+                for (int j = i + 1; j < n; j++)
+                {
+                    T* rowJ = tmp.row(j);
+                    T multiplier = rowJ[i]*inverse;
+                    rowJ[i] = multiplier;
+                    rowUpdate(rowJ + i + 1, rowI + i + 1, multiplier, k1 - i - 1);
+                    if(fused)
+                    {
+                        candidate = betterPivot(candidate, pivotCandidate{ (double)abs(rowJ[i + 1]), j });
+                    }
+                    moved += 2*(size_t)(k1 - i)*sizeof(T);
+                }
+                profileAdd(phasePanel, start);
+                trafficAdd(moved);
+                #pragma omp barrier
+            }
+
+            //U12 - rows of the panel to the right of it, solved with the unit lower triangle of the panel
+            //column tiles are independent of each other
+            profileMark start = profileClock();
+            size_t moved = 0;//a tile of the panel rows is read and written once, it stays in cache meanwhile
+            #pragma omp for schedule(runtime) nowait
+            for (int c0 = k1; c0 < tmp.width; c0 += updateTileWidth)
+            {
+                int c1 = min(c0 + updateTileWidth, tmp.width);
+                for (int i = k0; i < k1; i++)
+                {
+                    const T* rowI = tmp.row(i);
+                    for (int j = i + 1; j < k1; j++)
+                    {
+                        T* rowJ = tmp.row(j);
+                        rowUpdate(rowJ + c0, rowI + c0, rowJ[i], c1 - c0);
+                    }
+                }
+                moved += 2*(size_t)(k1 - k0)*(c1 - c0)*sizeof(T);
+            }
+            profileAdd(phasePanel, start);
+            trafficAdd(moved);
+            #pragma omp barrier
+
+            //trailing update A22 = A22 - L21*U12 done tile by tile so a tile of U12 stays in cache for all rows,
+            //column k1 of a row is final after it, so the row is offered as the first pivot of the next panel
+            start = profileClock();
+            moved = 0;//the tile of U12 stays in cache, a row of A22 and its multipliers are read and written once
+            #pragma omp for schedule(runtime) nowait reduction(maxPivot : candidate)
+            for (int j = k1; j < n; j++)
+            {
+                T* rowJ = tmp.row(j);
+                for (int c0 = k1; c0 < tmp.width; c0 += updateTileWidth)
+                {
+                    int c1 = min(c0 + updateTileWidth, tmp.width);
+                    for (int p = k0; p < k1; p++)
+                    {
+                        rowUpdate(rowJ + c0, tmp.row(p) + c0, rowJ[p], c1 - c0);
+                    }
+                }
+                candidate = betterPivot(candidate, pivotCandidate{ (double)abs(rowJ[k1]), j });
+                moved += 2*(size_t)(tmp.width - k0)*sizeof(T);
+            }
+            profileAdd(phaseTrailingUpdate, start);
+            trafficAdd(moved);
+            found = true;
+            #pragma omp barrier
+        }
+    }
+    return index;
+}
+
+//panel factorization of the task graph engine - columns k0..k1-1 with partial pivoting, the multipliers are
+//applied up to the end of the column block c1, which covers the augmented column in the last block
+//pivotStep records the position taken by every physical row that became a pivot row
+//returns the number of omitted rows
+template <typename T>
+int panelFactor(cMatrixT<T>& tmp, int k0, int k1, int c1, int* pivotStep)
+{
+    int index = 0;
+    int n = tmp.height;
+    for (int i = k0; i < k1; i++)
+    {
+        int maxIndex = pivotSearch(tmp, i, i, n);//searching for a maximum element
+        if(maxIndex!=i)
+        {
+            profileMark start = profileClock();
+            tmp.swapRows(i, maxIndex);
+            profileAdd(phaseRowSwap, start);
+        }
+        #pragma omp atomic write
+        pivotStep[tmp.perm[i]] = i;
+
+        const T* rowI = tmp.row(i);
+        if(rowI[i]==0){//rows with maximum element equal to 0 are omitted
+            index++;
+            continue;
+        }
+
+        T inverse = 1/rowI[i];
+        #pragma omp taskloop grainsize(updateTileWidth) shared(tmp)
+        for (int j = i + 1; j < n; j++)
+        {
+            profileMark start = profileClock();
+            T* rowJ = tmp.row(j);
+            T multiplier = rowJ[i]*inverse;
+            rowJ[i] = multiplier;
+            rowUpdate(rowJ + i + 1, rowI + i + 1, multiplier, c1 - i - 1);
+            profileAdd(phasePanel, start);
+            trafficAdd(2*(size_t)(c1 - i)*sizeof(T));
+        }
+    }
+    return index;
+}
+
+//tiled LU factorization expressed as a graph of OpenMP tasks
+//every column block has a dependency token: the panel task of step k owns block k, the update task of step k
+//for block j reads block k and owns block j, so the next panel starts as soon as its own block is updated
+//while the rest of the trailing update of the current step is still running (lookahead)
+//rows are exchanged only in the permutation, so update tasks walk physical rows and skip the ones
+//that already became pivot rows
+//returns the number of omitted rows
+template <typename T>
+int taskElimination(cMatrixT<T>& tmp, int blockSize)
+{
+    int n = tmp.height;
+    int panels = (n + blockSize - 1)/blockSize;
+    int columnBlocks = (tmp.width + blockSize - 1)/blockSize;
+    workspaceArray<char> tokens(columnBlocks);
+    char* token = tokens.data;//dependency tokens, only their addresses matter
+    workspaceArray<int> pivotStep(n);
+    int* step = pivotStep.data;
+    fill(step, step + n, INT_MAX);//rows of the trailing matrix keep INT_MAX
+    int index = 0;
+
+    #pragma omp parallel shared(tmp, index)
+    #pragma omp single
+    for (int k = 0; k < panels; k++)
+    {
+        int k0 = k*blockSize;
+        int k1 = min(k0 + blockSize, n);
+        int c1 = min(k0 + blockSize, tmp.width);
+
+        #pragma omp task depend(inout: token[k]) priority(2) shared(tmp, index) firstprivate(k0, k1, c1)
+        {
+            int omitted = panelFactor(tmp, k0, k1, c1, step);
+            #pragma omp atomic
+            index += omitted;
+        }
+
+        for (int j = k + 1; j < columnBlocks; j++)
+        {
+            int c0 = j*blockSize;
+            int c1 = min(c0 + blockSize, tmp.width);
+
+            #pragma omp task depend(in: token[k]) depend(inout: token[j]) priority(j == k + 1 ? 1 : 0) shared(tmp) firstprivate(k0, k1, c0, c1)
+            {
+                //U12 tile - rows of the panel, solved with its unit lower triangle
+                profileMark start = profileClock();
+                for (int i = k0; i < k1; i++)
+                {
+                    const T* rowI = tmp.row(i);
+                    for (int r = i + 1; r < k1; r++)
+                    {
+                        T* rowR = tmp.row(r);
+                        rowUpdate(rowR + c0, rowI + c0, rowR[i], c1 - c0);
+                    }
+                }
+                profileAdd(phasePanel, start);
+                trafficAdd(2*(size_t)(k1 - k0)*(c1 - c0)*sizeof(T));
+
+                //trailing tiles of the column block - rows that are not pivot rows yet
+                #pragma omp taskloop grainsize(blockSize) shared(tmp)
+                for (int p = 0; p < n; p++)
+                {
+                    int position;
+                    #pragma omp atomic read
+                    position = step[p];
+                    if(position < k1)
+                    {
+                        continue;
+                    }
+                    profileMark start = profileClock();
+                    T* rowP = tmp.data + (size_t)p*tmp.ld;
+                    for (int q = k0; q < k1; q++)
+                    {
+                        rowUpdate(rowP + c0, tmp.row(q) + c0, rowP[q], c1 - c0);
+                    }
+                    profileAdd(phaseTrailingUpdate, start);
+                    trafficAdd(2*(size_t)(c1 - c0 + k1 - k0)*sizeof(T));
+                }
+            }
+        }
+    }
+    return index;
+}
+
+//blocked triangular solve of the m vectors y[0..m-1] of length n with the factors in lu - unit lower (L) or upper (U)
+//every diagonal block is solved serially (over the right-hand sides in parallel), then the rest of the right-hand
+//sides is updated with the block of columns in parallel over rows, so one row segment of the factors serves all of them
+//the callers time it as a whole
+template <typename T>
+void triangularSolve(const cMatrixT<T>& lu, T* const* y, int m, bool lower)
+{
+    int n = lu.height;
+    int blocks = (n + substitutionBlock - 1)/substitutionBlock;
+    #pragma omp parallel
+    {
+        for (int b = 0; b < blocks; b++)
+        {
+            int k0 = (lower ? b : blocks - 1 - b)*substitutionBlock;
+            int k1 = min(k0 + substitutionBlock, n);
+            #pragma omp for schedule(static)
+            for (int c = 0; c < m; c++)//diagonal block
+            {
+                T* yc = y[c];
+                if(lower)
+                {
+                    for (int i = k0 + 1; i < k1; i++)
+                    {
+                        yc[i] -= dotProduct(lu.row(i) + k0, yc + k0, i - k0);
+                    }
+                }
+                else
+                {
+                    for (int i = k1 - 1; i >= k0; i--)
+                    {
+                        const T* rowI = lu.row(i);
+                        yc[i] = (yc[i] - dotProduct(rowI + i + 1, yc + i + 1, k1 - i - 1))/rowI[i];
+                    }
+                }
+            }
+
+            //rows below the block for L, above it for U
+            int r0 = lower ? k1 : 0;
+            int r1 = lower ? n : k0;
+            #pragma omp for schedule(runtime)
+            for (int i = r0; i < r1; i++)
+            {
+                const T* segment = lu.row(i) + k0;
+                for (int c = 0; c < m; c++)
+                {
+                    y[c][i] -= dotProduct(segment, y[c] + k0, k1 - k0);
+                }
+            }
+        }
+    }
+}
+
+//back substitution of a factored augmented matrix, the solution is written to the first row of result
+//small systems take a single vectorized dot product per row, larger ones the blocked solve
+template <typename T>
+void backSubstitution(const cMatrixT<T>& lu, cMatrixT<T>& result)
+{
+    profileMark start = profileClock();
+    T* x = result.row(0);
+    if(lu.height >= substitutionMinimum && omp_get_max_threads() > 1)
+    {
+        for (int i = 0; i < lu.height; i++)
+        {
+            x[i] = lu.row(i)[lu.width-1];
+        }
+        triangularSolve(lu, &x, 1, false);
+    }
+    else
+    {
+        for(int i = lu.height-1; i >= 0; i--)
+        {
+            const T* rowI = lu.row(i);
+            T tmpSum = dotProduct(rowI + i + 1, x + i + 1, lu.height - i - 1);
+            x[i] = (rowI[lu.width-1] - tmpSum)/rowI[i];
+        }
+    }
+    profileAdd(phaseBackSubstitution, start);
+}
+
+//reference sequential elimination with row pivoting followed by back substitution, the solution is written to the first row of result
+//returns the number of omitted rows
+template <typename T>
+int sequentialElimination(cMatrixT<T>& tmp, cMatrixT<T>& result)
+{
+    int index = 0;
+
+    //Stage 1 - elimination
+    for (int i = 0; i < tmp.height; i++)
+    {
+        int maxIndex = i;
+        for (int j = i; j < tmp.height; j++)//searching for a maximum element
+        {
+            if(abs(tmp.row(j)[i])>abs(tmp.row(maxIndex)[i]))
+            {
+                maxIndex = j;
+            }
+        }
+
+        if(maxIndex!=(i))//changing rows if needed - only the permutation entries are exchanged
+        {
+            tmp.swapRows(i, maxIndex);
+        }
+
+        if(tmp.row(i)[i]==0){//rows with maximum element equal to 0 are omitted
+            index++;
+            continue;
+        }
+
+        const T* rowI = tmp.row(i);
+        for (int j = i + 1; j < tmp.height; j++)//reduction
+        {
+            T* rowJ = tmp.row(j);
+            T tmpFloat = rowJ[i];//holds initial value for the calculations - it would normally change in process
+            for(int k = 0; k < tmp.width; k++)
+            {
+                rowJ[k] = rowJ[k] - tmpFloat*rowI[k]/rowI[i];
+            }
+        }
+    }
+
+    //tmp.screenPrint();//reordered input matrix can be printed to the screen
+
+    //Stage 2 - solution
+    for(int i = result.width-1; i >= 0; i--)
+    {
+        T tmpSum = 0;
+        for(int j = i; j < result.width; j++)
+        {
+            tmpSum += tmp.row(i)[j] * result.row(0)[j];
+        }
+        result.row(0)[i] = (tmp.row(i)[tmp.width-1] - tmpSum)/tmp.row(i)[i];
+    }
+    return index;
+}
+
+//factorization step - L (unit diagonal, below it), U and the row permutation are left in place of the matrix
+//for an augmented matrix the last column is transformed along with the rows
+//returns the number of omitted rows
+template <typename T>
+int luFactor(cMatrixT<T>& a)
+{
+    if(parameters.taskGraph)
+    {
+        return taskElimination(a, max(parameters.blockSize, minimumTileSize));
+    }
+    if(parameters.blockSize > 1)
+    {
+        return blockedElimination(a, parameters.blockSize);
+    }
+    return parallelElimination(a);
+}
+
+//solve step - O(n^2) for every right-hand side
+//rhs holds one right-hand side per column (height n, width m), solutions are returned as rows of x (height m, width n)
+template <typename T>
+void luSolve(const cMatrixT<T>& lu, const cMatrixT<T>& rhs, cMatrixT<T>& x)
+{
+    int n = lu.height;
+
+    if(n >= substitutionMinimum)//all right-hand sides go through the blocked solves together
+    {
+        workspaceArray<T*> y(rhs.width);
+        #pragma omp parallel for schedule(static)
+        for (int c = 0; c < rhs.width; c++)
+        {
+            y[c] = x.row(c);
+            for (int i = 0; i < n; i++)
+            {
+                y[c][i] = rhs.row(lu.perm[i])[c];
+            }
+        }
+        profileMark start = profileClock();
+        triangularSolve(lu, y.data, rhs.width, true);
+        triangularSolve(lu, y.data, rhs.width, false);
+        profileAdd(phaseBackSubstitution, start);//forward and back substitution of all right-hand sides
+        return;
+    }
+
+    #pragma omp parallel for schedule(runtime)
+    for (int c = 0; c < rhs.width; c++)
+    {
+        profileMark start = profileClock();
+        T* y = x.row(c);
+        for (int i = 0; i < n; i++)//forward substitution with the permuted right-hand side
+        {
+            y[i] = rhs.row(lu.perm[i])[c] - dotProduct(lu.row(i), y, i);
+        }
+        for (int i = n - 1; i >= 0; i--)//back substitution
+        {
+            const T* rowI = lu.row(i);
+            y[i] = (y[i] - dotProduct(rowI + i + 1, y + i + 1, n - i - 1))/rowI[i];
+        }
+        profileAdd(phaseBackSubstitution, start);//forward and back substitution of one right-hand side
+    }
+}
+
+//*************structured systems*******************************
+
+struct matrixStructure{
+    structureType type;
+    int lower, upper;//bandwidths below and above the diagonal
+};
+
+//bandwidths of the coefficient part of an augmented matrix; every row is scanned from both ends
+//up to its outermost nonzero, so a dense matrix is recognized after a few elements per row
+template <typename T>
+matrixStructure findStructure(const cMatrixT<T>& a)
+{
+    int n = a.height;
+    matrixStructure structure = { structureDense, n - 1, n - 1 };
+    switch (structureHint)
+    {
+        case hintDense:
+            return structure;
+        case hintUpperTriangular:
+            structure.type = structureUpperTriangular;
+            return structure;
+        case hintLowerTriangular:
+            structure.type = structureLowerTriangular;
+            return structure;
+        case hintTridiagonal:
+            structure.type = structureTridiagonal;
+            structure.lower = structure.upper = 1;
+            return structure;
+        default:
+            break;
+    }
+
+    int lower = 0, upper = 0;
+    #pragma omp parallel for schedule(static) reduction(max:lower,upper)
+    for (int i = 0; i < n; i++)
+    {
+        const T* rowI = a.row(i);
+        int first = 0;
+        while(first < i && rowI[first] == 0)
+        {
+            first++;
+        }
+        int last = n - 1;
+        while(last > i && rowI[last] == 0)
+        {
+            last--;
+        }
+        lower = max(lower, i - first);
+        upper = max(upper, last - i);
+    }
+    structure.lower = lower;
+    structure.upper = upper;
+
+    if(lower == 0)
+    {
+        structure.type = structureUpperTriangular;
+    }
+    else if(upper == 0)
+    {
+        structure.type = structureLowerTriangular;
+    }
+    else if(lower == 1 && upper == 1)
+    {
+        structure.type = structureTridiagonal;
+    }
+    else if(structureHint == hintBanded || (size_t)(2*lower + upper + 1)*bandedFraction <= (size_t)n)
+    {
+        structure.type = structureBanded;
+    }
+    return structure;
+}
+
+//forward substitution of a lower triangular augmented matrix, the solution is written to the first row of result
+template <typename T>
+int forwardSubstitution(const cMatrixT<T>& a, cMatrixT<T>& result)
+{
+    int index = 0;
+    T* x = result.row(0);
+    for (int i = 0; i < a.height; i++)
+    {
+        const T* rowI = a.row(i);
+        if(rowI[i] == 0)//rows with a zero on the diagonal are omitted
+        {
+            x[i] = 0;
+            index++;
+            continue;
+        }
+        x[i] = (rowI[a.width-1] - dotProduct(rowI, x, i))/rowI[i];
+    }
+    return index;
+}
+
+//Thomas algorithm for a tridiagonal augmented matrix - O(n), without pivoting,
+//so it is used only for diagonally dominant systems
+template <typename T>
+int thomasSolve(const cMatrixT<T>& a, cMatrixT<T>& result)
+{
+    int n = a.height;
+    workspaceArray<T> super(n);//modified superdiagonal
+    T* x = result.row(0);
+    for (int i = 0; i < n; i++)
+    {
+        const T* rowI = a.row(i);
+        T sub = (i > 0) ? rowI[i-1] : 0;
+        T denominator = rowI[i] - ((i > 0) ? sub*super[i-1] : 0);
+        if(denominator == 0)
+        {
+            return n - i;
+        }
+        super[i] = (i < n - 1) ? rowI[i+1]/denominator : 0;
+        x[i] = (rowI[a.width-1] - ((i > 0) ? sub*x[i-1] : 0))/denominator;
+    }
+    for (int i = n - 2; i >= 0; i--)
+    {
+        x[i] -= super[i]*x[i+1];
+    }
+    return 0;
+}
+
+template <typename T>
+bool diagonallyDominant(const cMatrixT<T>& a, const matrixStructure& structure)
+{
+    int n = a.height;
+    for (int i = 0; i < n; i++)
+    {
+        const T* rowI = a.row(i);
+        T offDiagonal = 0;
+        for (int j = max(0, i - structure.lower); j <= min(n - 1, i + structure.upper); j++)
+        {
+            offDiagonal += (j != i) ? abs(rowI[j]) : 0;
+        }
+        if(abs(rowI[i]) < offDiagonal || rowI[i] == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//banded LU with partial pivoting, only the band is stored: row i keeps the columns i-lower..i+upper+lower,
+//where the extra lower columns take the fill of the row exchanges; O(n*lower*(lower+upper))
+//the rows below a pivot are updated in parallel when the band is wide enough to pay for the barriers of a step
+template <typename T>
+int bandedSolve(const cMatrixT<T>& a, const matrixStructure& structure, cMatrixT<T>& result)
+{
+    int n = a.height;
+    int kl = structure.lower;
+    int ku = structure.upper;
+    int w = 2*kl + ku + 1;//stored width of a row
+    workspaceArray<T> band((size_t)n*w);
+    workspaceArray<T> b(n);
+    fill(band.data, band.data + (size_t)n*w, (T)0);
+    #define BAND(i, j) band[(size_t)(i)*w + (j) - (i) + kl]
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++)
+    {
+        const T* rowI = a.row(i);
+        for (int j = max(0, i - kl); j <= min(n - 1, i + ku); j++)
+        {
+            BAND(i, j) = rowI[j];
+        }
+        b[i] = rowI[a.width-1];
+    }
+
+    int index = 0;
+    #pragma omp parallel if((size_t)kl*(kl + ku) >= bandedParallelWork) shared(index)
+    for (int k = 0; k < n; k++)
+    {
+        int last = min(n - 1, k + kl);//last row with a nonzero in column k
+        int right = min(n - 1, k + kl + ku);//last column reached by the pivot row
+        #pragma omp single
+        {
+            int p = k;
+            for (int r = k + 1; r <= last; r++)
+            {
+                if(abs(BAND(r, k)) > abs(BAND(p, k)))
+                {
+                    p = r;
+                }
+            }
+            if(BAND(p, k) == 0)//rows with maximum element equal to 0 are omitted
+            {
+                index++;
+            }
+            else if(p != k)//both windows hold columns k..right
+            {
+                for (int j = k; j <= right; j++)
+                {
+                    swap(BAND(k, j), BAND(p, j));
+                }
+                swap(b[k], b[p]);
+            }
+        }
+        if(BAND(k, k) == 0)//the pivot is final after the single, only the omitted ones are 0
+        {
+            continue;
+        }
+        T inverse = 1/BAND(k, k);
+        #pragma omp for schedule(static)
+        for (int r = k + 1; r <= last; r++)
+        {
+            T multiplier = BAND(r, k)*inverse;
+            BAND(r, k) = 0;
+            rowUpdate(&BAND(r, k + 1), &BAND(k, k + 1), multiplier, right - k);
+            b[r] -= multiplier*b[k];
+        }
+    }
+
+    T* x = result.row(0);
+    for (int i = n - 1; i >= 0; i--)
+    {
+        int right = min(n - 1, i + kl + ku);
+        T diagonal = BAND(i, i);
+        x[i] = (diagonal == 0) ? 0 : (b[i] - dotProduct(&BAND(i, i + 1), x + i + 1, right - i))/diagonal;
+    }
+    #undef BAND
+    return index;
+}
+
+//solves an augmented matrix of a recognized structure without changing it, the solution is written to the first
+//row of result; returns the number of omitted rows
+template <typename T>
+int structuredSolve(const cMatrixT<T>& a, const matrixStructure& structure, cMatrixT<T>& result)
+{
+    int index = 0;
+    switch (structure.type)
+    {
+        case structureUpperTriangular:
+            for (int i = 0; i < a.height; i++)
+            {
+                index += (a.row(i)[i] == 0);
+            }
+            if(index == 0)
+            {
+                backSubstitution(a, result);
+            }
+            break;
+        case structureLowerTriangular:
+            index = forwardSubstitution(a, result);
+            break;
+        case structureTridiagonal:
+            if(diagonallyDominant(a, structure))
+            {
+                index = thomasSolve(a, result);
+                break;
+            }
+            index = bandedSolve(a, structure, result);
+            break;
+        default:
+            index = bandedSolve(a, structure, result);
+    }
+    return index;
+}
+
+const char* structureName(structureType type)
+{
+    switch (type)
+    {
+        case structureUpperTriangular:
+            return "upper triangular";
+        case structureLowerTriangular:
+            return "lower triangular";
+        case structureTridiagonal:
+            return "tridiagonal";
+        case structureBanded:
+            return "banded";
+        default:
+            return "dense";
+    }
+}
+
+//*************sparse systems*******************************
+
+const double sparsePivotThreshold = 0.1;//the diagonal is kept as the pivot while it is at least this part of the column maximum
+
+const int dissectionLeaf = 64;//parts of the nested dissection that are not split any more
+
+const int dissectionBandwidth = 64;//reverse Cuthill-McKee orders with a wider band are replaced by nested dissection
+
+//compressed sparse column storage
+template <typename T>
+struct sparseMatrix{
+    int n;//columns
+    vector<int> p;//start of every column in i and x, n+1 entries
+    vector<int> i;//row indices
+    vector<T> x;//values
+};
+
+//reads a square system from a Matrix Market coordinate file (real or integer, general or symmetric);
+//the file holds the augmented matrix - n rows and n+1 columns, the last column is the right-hand side
+//returns false when the file cannot be read or has another shape
+template <typename T>
+bool readMatrixMarket(string name, sparseMatrix<T>* a, vector<T>* b)
+{
+    int sourceFile = open(name.c_str(), O_RDONLY);
+    struct stat fileInfo;
+    if(sourceFile < 0 || fstat(sourceFile, &fileInfo) != 0 || fileInfo.st_size == 0)
+    {
+        if(sourceFile >= 0)
+        {
+            close(sourceFile);
+        }
+        return false;
+    }
+    size_t fileSize = fileInfo.st_size;
+    void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, sourceFile, 0);
+    close(sourceFile);
+    if(mapped == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(mapped, fileSize, MADV_SEQUENTIAL);
+    const char* text = (const char*)mapped;
+    const char* end = text + fileSize;
+
+    const char* lineEnd = (const char*)memchr(text, '\n', fileSize);
+    string banner(text, lineEnd ? lineEnd : end);
+    bool symmetric = banner.find("symmetric") != string::npos;
+    bool valid = banner.compare(0, 14, "%%MatrixMarket") == 0 && banner.find("coordinate") != string::npos
+        && banner.find("complex") == string::npos && banner.find("pattern") == string::npos;
+
+    //comments and blank lines before the size line
+    const char* cursor = text;
+    while(cursor < end && (*cursor == '%' || isspace((unsigned char)*cursor)))
+    {
+        if(*cursor == '%')
+        {
+            const char* next = (const char*)memchr(cursor, '\n', end - cursor);
+            cursor = next ? next : end;
+        }
+        else
+        {
+            cursor++;
+        }
+    }
+
+    long long rows = 0, columns = 0, entries = 0;
+    cursor = parseValue(cursor, end, &rows);
+    cursor = parseValue(cursor, end, &columns);
+    cursor = parseValue(cursor, end, &entries);
+    valid = valid && rows > 0 && rows < INT_MAX && columns == rows + 1 && entries >= 0;
+    //the count is checked before it sizes anything - an entry takes at least "r c v" and a line break
+    valid = valid && entries <= rows*columns && entries <= (long long)(end - cursor)/6 + 1;
+
+    int n = (int)rows;
+    vector<int> entryRow, entryColumn;
+    vector<T> entryValue;
+    if(valid)
+    {
+        entryRow.reserve(entries);
+        entryColumn.reserve(entries);
+        entryValue.reserve(entries);
+        b->assign(n, 0);
+    }
+    for (long long e = 0; valid && e < entries; e++)
+    {
+        long long r = 0, c = 0;
+        T value = 0;
+        while(cursor < end && isspace((unsigned char)*cursor))
+        {
+            cursor++;
+        }
+        cursor = parseValue(cursor, end, &r);
+        cursor = parseValue(cursor, end, &c);
+        cursor = parseValue(cursor, end, &value);
+        if(r < 1 || r > rows || c < 1 || c > columns)
+        {
+            valid = false;
+            break;
+        }
+        if(c == columns)
+        {
+            (*b)[r - 1] += value;
+            continue;
+        }
+        entryRow.push_back((int)r - 1);
+        entryColumn.push_back((int)c - 1);
+        entryValue.push_back(value);
+        if(symmetric && r != c)
+        {
+            entryRow.push_back((int)c - 1);
+            entryColumn.push_back((int)r - 1);
+            entryValue.push_back(value);
+        }
+    }
+    munmap(mapped, fileSize);
+    if(!valid)
+    {
+        return false;
+    }
+
+    //counting sort by column, duplicates are summed
+    a->n = n;
+    a->p.assign(n + 1, 0);
+    for (size_t e = 0; e < entryColumn.size(); e++)
+    {
+        a->p[entryColumn[e] + 1]++;
+    }
+    for (int j = 0; j < n; j++)
+    {
+        a->p[j + 1] += a->p[j];
+    }
+    vector<int> next(a->p.begin(), a->p.end() - 1);
+    a->i.resize(entryColumn.size());
+    a->x.resize(entryColumn.size());
+    for (size_t e = 0; e < entryColumn.size(); e++)
+    {
+        int position = next[entryColumn[e]]++;
+        a->i[position] = entryRow[e];
+        a->x[position] = entryValue[e];
+    }
+    vector<int> last(n, -1);
+    int count = 0;
+    for (int j = 0; j < n; j++)
+    {
+        int start = count;
+        for (int q = a->p[j]; q < a->p[j + 1]; q++)
+        {
+            int r = a->i[q];
+            if(last[r] >= start)
+            {
+                a->x[last[r]] += a->x[q];
+                continue;
+            }
+            last[r] = count;
+            a->i[count] = r;
+            a->x[count++] = a->x[q];
+        }
+        a->p[j] = start;
+    }
+    a->p[n] = count;
+    a->i.resize(count);
+    a->x.resize(count);
+    return true;
+}
+
+//adjacency of the pattern of A+A^T without the diagonal
+struct sparseGraph{
+    vector<int> start;//start of the neighbours of every node, n+1 entries
+    vector<int> adjacent;
+    vector<int> degree;
+};
+
+template <typename T>
+sparseGraph symmetricGraph(const sparseMatrix<T>& a)
+{
+    int n = a.n;
+    sparseGraph g;
+    g.degree.assign(n, 0);
+    for (int j = 0; j < n; j++)
+    {
+        for (int q = a.p[j]; q < a.p[j + 1]; q++)
+        {
+            if(a.i[q] != j)
+            {
+                g.degree[j]++;
+                g.degree[a.i[q]]++;
+            }
+        }
+    }
+    g.start.assign(n + 1, 0);
+    for (int j = 0; j < n; j++)
+    {
+        g.start[j + 1] = g.start[j] + g.degree[j];
+    }
+    g.adjacent.resize(g.start[n]);
+    vector<int> fill(g.start.begin(), g.start.end() - 1);
+    for (int j = 0; j < n; j++)
+    {
+        for (int q = a.p[j]; q < a.p[j + 1]; q++)
+        {
+            int r = a.i[q];
+            if(r != j)
+            {
+                g.adjacent[fill[j]++] = r;
+                g.adjacent[fill[r]++] = j;
+            }
+        }
+    }
+    return g;
+}
+
+//reverse Cuthill-McKee ordering - keeps the nonzeros close to the diagonal, so the fill stays inside the band;
+//every connected component starts from a pseudo-peripheral node of low degree
+vector<int> reverseCuthillMcKee(const sparseGraph& g)
+{
+    int n = g.degree.size();
+    const vector<int>& start = g.start;
+    const vector<int>& adjacent = g.adjacent;
+    const vector<int>& degree = g.degree;
+
+    vector<int> order;
+    order.reserve(n);
+    vector<int> level(n, -1);
+    vector<int> byDegree(n);
+    for (int j = 0; j < n; j++)
+    {
+        byDegree[j] = j;
+    }
+    stable_sort(byDegree.begin(), byDegree.end(), [&](int x, int y) { return degree[x] < degree[y]; });
+
+    for (int s = 0; s < n; s++)
+    {
+        int root = byDegree[s];
+        if(level[root] >= 0)
+        {
+            continue;
+        }
+        //a breadth-first pass from the lowest degree node, then the search starts again from the
+        //lowest degree node of the last level, which lies far away on the component
+        size_t first = order.size();
+        for (int pass = 0; pass < 2; pass++)
+        {
+            order.resize(first);
+            order.push_back(root);
+            level[root] = 0;
+            for (size_t head = first; head < order.size(); head++)
+            {
+                int node = order[head];
+                size_t added = order.size();
+                for (int q = start[node]; q < start[node + 1]; q++)
+                {
+                    if(level[adjacent[q]] < 0)
+                    {
+                        level[adjacent[q]] = level[node] + 1;
+                        order.push_back(adjacent[q]);
+                    }
+                }
+                sort(order.begin() + added, order.end(), [&](int x, int y) { return degree[x] < degree[y]; });
+            }
+            if(pass == 0)
+            {
+                int deepest = level[order.back()];
+                for (size_t q = first; q < order.size(); q++)
+                {
+                    if(level[order[q]] == deepest && (level[root] != deepest || degree[order[q]] < degree[root]))
+                    {
+                        root = order[q];
+                    }
+                }
+                for (size_t q = first; q < order.size(); q++)
+                {
+                    level[order[q]] = -1;
+                }
+            }
+        }
+    }
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+//largest distance between a node and its neighbours in the order
+int orderBandwidth(const sparseGraph& g, const vector<int>& order)
+{
+    int n = g.degree.size();
+    vector<int> position(n);
+    for (int k = 0; k < n; k++)
+    {
+        position[order[k]] = k;
+    }
+    int bandwidth = 0;
+    for (int j = 0; j < n; j++)
+    {
+        for (int q = g.start[j]; q < g.start[j + 1]; q++)
+        {
+            bandwidth = max(bandwidth, abs(position[j] - position[g.adjacent[q]]));
+        }
+    }
+    return bandwidth;
+}
+
+//breadth-first search over the nodes carrying the label of root, the visited nodes are appended to queue
+void labelledSearch(const sparseGraph& g, int root, const vector<int>& label, vector<int>& level, vector<int>& queue)
+{
+    size_t head = queue.size();
+    queue.push_back(root);
+    level[root] = 0;
+    for (; head < queue.size(); head++)
+    {
+        int node = queue[head];
+        for (int q = g.start[node]; q < g.start[node + 1]; q++)
+        {
+            int next = g.adjacent[q];
+            if(level[next] < 0 && label[next] == label[root])
+            {
+                level[next] = level[node] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+//nested dissection of the nodes of one label: the middle level of a level structure from a pseudo-peripheral node
+//separates the part into two halves, which are ordered first, the separator is ordered after them;
+//parts of unconnected components are dissected one component at a time
+void dissect(const sparseGraph& g, vector<int> nodes, vector<int>& label, int* nextLabel, vector<int>& level, vector<int>& order)
+{
+    if((int)nodes.size() <= dissectionLeaf)
+    {
+        order.insert(order.end(), nodes.begin(), nodes.end());
+        return;
+    }
+
+    vector<int> component;
+    labelledSearch(g, nodes[0], label, level, component);
+    if(component.size() < nodes.size())
+    {
+        vector<vector<int>> components;
+        for (size_t k = 0; k < nodes.size(); k++)
+        {
+            if(level[nodes[k]] < 0)
+            {
+                components.push_back(vector<int>());
+                labelledSearch(g, nodes[k], label, level, components.back());
+            }
+        }
+        components.push_back(component);
+        for (size_t k = 0; k < nodes.size(); k++)
+        {
+            level[nodes[k]] = -1;
+        }
+        for (size_t c = 0; c < components.size(); c++)
+        {
+            int part = (*nextLabel)++;
+            for (size_t k = 0; k < components[c].size(); k++)
+            {
+                label[components[c][k]] = part;
+            }
+            dissect(g, components[c], label, nextLabel, level, order);
+        }
+        return;
+    }
+
+    int root = component.back();//the last node reached lies far from the first one
+    for (size_t k = 0; k < component.size(); k++)
+    {
+        level[component[k]] = -1;
+    }
+    component.clear();
+    labelledSearch(g, root, label, level, component);
+
+    int depth = level[component.back()];
+    if(depth < 2)
+    {
+        for (size_t k = 0; k < component.size(); k++)
+        {
+            level[component[k]] = -1;
+        }
+        order.insert(order.end(), component.begin(), component.end());
+        return;
+    }
+    int middle = min(max(level[component[component.size()/2]], 1), depth - 1);
+
+    vector<int> first, second, separator;
+    int firstLabel = (*nextLabel)++;
+    int secondLabel = (*nextLabel)++;
+    for (size_t k = 0; k < component.size(); k++)
+    {
+        int node = component[k];
+        if(level[node] < middle)
+        {
+            first.push_back(node);
+            label[node] = firstLabel;
+        }
+        else if(level[node] > middle)
+        {
+            second.push_back(node);
+            label[node] = secondLabel;
+        }
+        else
+        {
+            separator.push_back(node);
+            label[node] = -1;
+        }
+        level[node] = -1;
+    }
+    component.clear();
+    component.shrink_to_fit();
+    nodes.clear();
+    nodes.shrink_to_fit();
+    dissect(g, first, label, nextLabel, level, order);
+    dissect(g, second, label, nextLabel, level, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+}
+
+//fill-reducing column order - reverse Cuthill-McKee when it gives a narrow band, nested dissection otherwise
+//(meshes of two and more dimensions, where a band of width sqrt(n) and more would fill in completely)
+template <typename T>
+vector<int> fillReducingOrder(const sparseMatrix<T>& a, bool* dissection)
+{
+    int n = a.n;
+    sparseGraph g = symmetricGraph(a);
+    vector<int> order = reverseCuthillMcKee(g);
+    *dissection = orderBandwidth(g, order) > dissectionBandwidth;
+    if(!*dissection)
+    {
+        return order;
+    }
+
+    vector<int> nodes(n);
+    for (int j = 0; j < n; j++)
+    {
+        nodes[j] = j;
+    }
+    vector<int> label(n, 0);
+    vector<int> level(n, -1);
+    int nextLabel = 1;
+    order.clear();
+    dissect(g, nodes, label, &nextLabel, level, order);
+    return order;
+}
+
+//rows reachable from the nonzeros of column col of A in the graph of L, in topological order in xi[top..n-1]
+template <typename T>
+int sparseReach(const sparseMatrix<T>& l, const sparseMatrix<T>& a, int col, vector<int>& xi, vector<int>& stack,
+    vector<int>& position, const vector<int>& pinv, vector<char>& marked)
+{
+    int n = a.n;
+    int top = n;
+    for (int q = a.p[col]; q < a.p[col + 1]; q++)
+    {
+        int j = a.i[q];
+        if(marked[j])
+        {
+            continue;
+        }
+        //depth-first search without recursion
+        int head = 0;
+        stack[0] = j;
+        while(head >= 0)
+        {
+            j = stack[head];
+            int column = pinv[j];//column of L that eliminated row j, -1 while j is not a pivot row
+            if(!marked[j])
+            {
+                marked[j] = 1;
+                position[head] = (column < 0) ? 0 : l.p[column] + 1;//the unit diagonal comes first
+            }
+            bool done = true;
+            int stop = (column < 0) ? 0 : l.p[column + 1];
+            for (int q2 = position[head]; q2 < stop; q2++)
+            {
+                int r = l.i[q2];
+                if(marked[r])
+                {
+                    continue;
+                }
+                position[head] = q2;
+                stack[++head] = r;
+                done = false;
+                break;
+            }
+            if(done)
+            {
+                head--;
+                xi[--top] = j;
+            }
+        }
+    }
+    for (int q = top; q < n; q++)
+    {
+        marked[xi[q]] = 0;
+    }
+    return top;
+}
+
+//left-looking sparse LU (Gilbert-Peierls) of the columns of A taken in the order q, with threshold partial
+//pivoting; L (unit diagonal first in every column) and U (diagonal last in every column) hold row indices of
+//the pivot order, pinv maps the rows of A to it; returns the number of columns without a pivot
+template <typename T>
+int sparseFactor(const sparseMatrix<T>& a, const vector<int>& q, sparseMatrix<T>* l, sparseMatrix<T>* u, vector<int>* pinv)
+{
+    int n = a.n;
+    l->n = u->n = n;
+    l->p.assign(n + 1, 0);
+    u->p.assign(n + 1, 0);
+    l->i.clear(); l->x.clear();
+    u->i.clear(); u->x.clear();
+    l->i.reserve(4*a.i.size() + n); l->x.reserve(4*a.i.size() + n);
+    u->i.reserve(4*a.i.size() + n); u->x.reserve(4*a.i.size() + n);
+    pinv->assign(n, -1);
+    vector<T> x(n, 0);
+    vector<int> xi(n), stack(n), position(n);
+    vector<char> marked(n, 0);
+    int omitted = 0;
+
+    for (int k = 0; k < n; k++)
+    {
+        l->p[k] = l->i.size();
+        u->p[k] = u->i.size();
+        int col = q[k];
+
+        //x = L \ A(:,col) over the reachable rows only
+        int top = sparseReach(*l, a, col, xi, stack, position, *pinv, marked);
+        for (int p = a.p[col]; p < a.p[col + 1]; p++)
+        {
+            x[a.i[p]] = a.x[p];
+        }
+        for (int p = top; p < n; p++)
+        {
+            int j = xi[p];
+            int column = (*pinv)[j];
+            if(column < 0)
+            {
+                continue;
+            }
+            for (int r = l->p[column] + 1; r < l->p[column + 1]; r++)
+            {
+                x[l->i[r]] -= l->x[r]*x[j];
+            }
+        }
+
+        //rows that were pivots give U, the largest of the others is the pivot candidate
+        int pivotRow = -1;
+        T largest = 0;
+        for (int p = top; p < n; p++)
+        {
+            int r = xi[p];
+            if((*pinv)[r] < 0)
+            {
+                if(abs(x[r]) > largest)
+                {
+                    largest = abs(x[r]);
+                    pivotRow = r;
+                }
+            }
+            else
+            {
+                u->i.push_back((*pinv)[r]);
+                u->x.push_back(x[r]);
+            }
+        }
+        if(pivotRow < 0)//structurally or numerically singular column
+        {
+            omitted++;
+            u->i.push_back(k);
+            u->x.push_back(0);
+            for (int p = top; p < n; p++)
+            {
+                x[xi[p]] = 0;
+            }
+            l->i.push_back(-1);//placeholder of the diagonal, the pivot row is chosen after the last column
+            l->x.push_back(1);
+            continue;
+        }
+        if((*pinv)[col] < 0 && abs(x[col]) >= sparsePivotThreshold*largest)
+        {
+            pivotRow = col;//the diagonal keeps the ordering and its fill
+        }
+
+        T pivot = x[pivotRow];
+        u->i.push_back(k);
+        u->x.push_back(pivot);
+        (*pinv)[pivotRow] = k;
+        l->i.push_back(pivotRow);
+        l->x.push_back(1);
+        for (int p = top; p < n; p++)
+        {
+            int r = xi[p];
+            if((*pinv)[r] < 0)
+            {
+                l->i.push_back(r);
+                l->x.push_back(x[r]/pivot);
+            }
+            x[r] = 0;
+        }
+    }
+    l->p[n] = l->i.size();
+    u->p[n] = u->i.size();
+
+    //rows left without a pivot go to the columns that had none
+    if(omitted > 0)
+    {
+        int r = 0;
+        for (int k = 0; k < n; k++)
+        {
+            if(l->i[l->p[k]] == -1)
+            {
+                while((*pinv)[r] >= 0)
+                {
+                    r++;
+                }
+                (*pinv)[r] = k;
+                l->i[l->p[k]] = r;
+            }
+        }
+    }
+    for (size_t p = 0; p < l->i.size(); p++)
+    {
+        l->i[p] = (*pinv)[l->i[p]];
+    }
+    return omitted;
+}
+
+//solution of A x = b from the factors: permuted forward substitution with L, back substitution with U,
+//then the column order is undone; columns without a pivot give zero
+template <typename T>
+void sparseSolve(const sparseMatrix<T>& l, const sparseMatrix<T>& u, const vector<int>& q, const vector<int>& pinv,
+    const vector<T>& b, T* result)
+{
+    int n = l.n;
+    vector<T> y(n);
+    for (int r = 0; r < n; r++)
+    {
+        y[pinv[r]] = b[r];
+    }
+    for (int j = 0; j < n; j++)
+    {
+        for (int p = l.p[j] + 1; p < l.p[j + 1]; p++)
+        {
+            y[l.i[p]] -= l.x[p]*y[j];
+        }
+    }
+    for (int j = n - 1; j >= 0; j--)
+    {
+        T diagonal = u.x[u.p[j + 1] - 1];
+        y[j] = (diagonal == 0) ? 0 : y[j]/diagonal;
+        for (int p = u.p[j]; p < u.p[j + 1] - 1; p++)
+        {
+            y[u.i[p]] -= u.x[p]*y[j];
+        }
+    }
+    for (int k = 0; k < n; k++)
+    {
+        result[q[k]] = y[k];
+    }
+}
+
+//stores factors with the permutation in the binary format so that later runs skip the factorization
+bool storeFactors(cMatrix& lu, string name)
+{
+    dataLogger += endOfLine;
+    dataLogger += "Factors writing... ";
+    dataLogger += name;
+    dataLogger += "...";
+
+    if(!lu.binaryWrite(name, layoutAugmented, true)){
+        dataLogger += "Cannot write files.";
+        return false;
+    }
+    dataLogger += " OK";
+    cout<<"Factors writing: OK"<<endl;
+    return true;
+}
+
+//factorizes a copy of the augmented matrix once, the result can be stored and solved for many right-hand sides
+cMatrix matrixFactorization(cMatrix* matrixArg, bool* errors)
+{
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+
+    dataLogger += endOfLine;
+    dataLogger += "LU factorization time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", amount of equations: ";
+    dataLogger += to_string(matrixArg->height);
+    dataLogger += ", ";
+
+    if (matrixArg->errorFlag || matrixArg->width < matrixArg->height){
+        std::cout<<"Input error."<<std::endl;
+        dataLogger += "Input error.";
+        *errors = true;
+        cMatrix result = cMatrix(1, 1);
+        return result;
+    }
+
+    cMatrix lu = cMatrix(*matrixArg);
+    double time = omp_get_wtime();
+    int index = luFactor(lu);
+    lu.timePar = omp_get_wtime() - time;
+
+    std::cout<<"Factorization time: "<<lu.timePar<<std::endl;
+    dataLogger += "factorization time: ";
+    dataLogger += to_string(lu.timePar);
+    dataLogger += ", ";
+    dataLogger += to_string(index);
+    dataLogger += " rows omitted";
+
+    if(index == 0)
+    {
+        std::cout<<"LU factorization: OK"<<std::endl;
+        dataLogger += "...OK";
+    }
+    else
+    {
+        std::cout<<"LU factorization: OK - some rows were omitted, so the results will be incorrect."<<std::endl;
+        dataLogger += "...OK - some rows were omitted, so the results will be incorrect.";
+    }
+    *errors = false;
+    return lu;
+}
+
+//solves stored factors for a block of right-hand sides, one solution per row of the result
+cMatrix matrixSolve(cMatrix* factors, cMatrix* rhs, bool* errors)
+{
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+
+    dataLogger += endOfLine;
+    dataLogger += "Solving with factors time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", amount of equations: ";
+    dataLogger += to_string(factors->height);
+    dataLogger += ", right-hand sides: ";
+    dataLogger += to_string(rhs->width);
+    dataLogger += ", ";
+
+    if (factors->errorFlag || rhs->errorFlag){
+        std::cout<<"Input error."<<std::endl;
+        dataLogger += "Input error.";
+        *errors = true;
+        cMatrix result = cMatrix(1, 1);
+        return result;
+    }
+
+    if (rhs->height != factors->height){
+        std::cout<<"Dimension mismatch. Solving."<<std::endl;
+        dataLogger += "Dimension mismatch. Solving.";
+        *errors = true;
+        cMatrix result = cMatrix(1, 1);
+        return result;
+    }
+
+    cMatrix result = cMatrix(factors->height, rhs->width);
+    double time = omp_get_wtime();
+    luSolve(*factors, *rhs, result);
+    result.timePar = omp_get_wtime() - time;
+
+    std::cout<<"Solving time: "<<result.timePar<<std::endl;
+    dataLogger += "solving time: ";
+    dataLogger += to_string(result.timePar);
+    dataLogger += "...OK";
+    *errors = false;
+    return result;
+}
+
+template <typename T>
+cMatrixT<T> matrixGaussianElimination(cMatrixT<T>* matrixArg, bool* errors, bool inPlace = false)
+//gives the Gaussian elimination solution vector (matrix type) of a given matrix
+//inPlace - the matrix is overwritten by its factors instead of being copied
+{
+    /*taken from an omp enum sched type declaration
+    omp_sched_static = 1,
+    omp_sched_dynamic = 2,
+    omp_sched_guided = 3,
+    omp_sched_auto = 4
+    */
+    parallelParam saved = parameters;//tuned parameters are used for this call only
+    bool tuned = useTuning && tunedParameters(matrixArg->height, &parameters);
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+    int index = 0;
+    double time;
+
+    dataLogger += endOfLine;
+    dataLogger += "Gaussian elimination time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", amount of equations: ";
+    dataLogger += to_string(matrixArg->height);
+    dataLogger += ", ";
+    dataLogger += verification ? "verification mode, " : "production mode, ";
+    dataLogger += tuned ? "autotuned, " : "";
+    dataLogger += "parallel schedule type: ";
+    if(parameters.taskGraph)
+    {
+        dataLogger += "task graph";
+    }
+    else
+    {
+        switch (parameters.scheduleType)
+        {
+            case 1:
+                dataLogger += "static";
+                break;
+            case 2:
+                dataLogger += "dynamic";
+                break;
+            case 3:
+                dataLogger += "guided";
+                break;
+            case 4:
+                dataLogger += "auto";
+                break;
+            default:
+                dataLogger += "unknown";
+        }
+    }
+    dataLogger += ", ";
+    dataLogger += "parallel size of chunk: ";
+    dataLogger += to_string(parameters.chunkSize);
+    dataLogger += ", ";
+    dataLogger += "parallel wanted number of threads: ";
+    dataLogger += to_string(parameters.wantedThreads);
+    dataLogger += ", ";
+    dataLogger += "block size: ";
+    dataLogger += to_string(parameters.blockSize);
+    dataLogger += ", ";
+    dataLogger += "kernels: ";
+    dataLogger += kernels.name;
+    dataLogger += ", ";
+    dataLogger += "precision: ";
+    dataLogger += (sizeof(T) == sizeof(float)) ? "float" : "double";
+    dataLogger += ", ";
+
+    if (matrixArg->errorFlag){
+        std::cout<<"Input error."<<std::endl;
+        dataLogger += "Input error.";
+        *errors = true;
+        parameters = saved;
+        cMatrixT<T> result = cMatrixT<T>(1, 1);
+        return result;
+    }
+
+    if (matrixArg->width!=(matrixArg->height)+1){
+        std::cout<<"Dimension mismatch. Elimination."<<std::endl;
+        dataLogger += "Dimension mismatch. Elimination.";
+        *errors = true;
+        parameters = saved;
+        cMatrixT<T> result = cMatrixT<T>(1, 1);
+        return result;
+    }
+
+    cMatrixT<T> result = cMatrixT<T>(matrixArg->height, 1);//result declaration
+    cMatrixT<T> reference = cMatrixT<T>(verification ? matrixArg->height : 1, 1);//solution of the sequential run
+
+    //*************sequence part - verification mode only*******************************
+    if(verification)
+    {
+        cMatrixT<T> tmp = cMatrixT<T>(*matrixArg);//to keep original input values a matrix copy is created
+        time = omp_get_wtime();
+
+        index = sequentialElimination(tmp, reference);
+        if(index > 0)
+        {
+            *errors = true;
+        }
+
+        time = omp_get_wtime() - time;
+        result.timeSeq = time;
+
+        std::cout<<"Sequence time: "<<result.timeSeq<<std::endl;
+        dataLogger += "sequence time: ";
+        dataLogger += to_string(result.timeSeq);
+        dataLogger += ", ";
+        dataLogger += to_string(index);
+        dataLogger += " rows omitted in sequence part, ";
+        index = 0;
+    }
+
+    //*************parallel part*******************************
+    trafficReset();
+    counterMark();
+    time = omp_get_wtime();
+    matrixStructure structure = findStructure(*matrixArg);
+    if(structure.type != structureDense)
+    {
+        //banded and triangular systems skip the dense elimination, the input is only read
+        index = structuredSolve(*matrixArg, structure, result);
+    }
+    else
+    {
+        //the selected engine factors the caller's matrix when its values are not needed afterwards,
+        //otherwise a copy, so the sequential part always starts from the original input
+        cMatrixT<T>* copy = inPlace ? NULL : new cMatrixT<T>(*matrixArg);
+        cMatrixT<T>& tmp2 = inPlace ? *matrixArg : *copy;
+
+        //Stage 1 - elimination, the forward substitution is done together with it on the augmented column
+        index = luFactor(tmp2);
+
+        //cout<<index<<" rows omitted."<<endl;//rows omitted can be printed to the screen
+        //tmp2.screenPrint();//reordered input matrix can be printed to the screen
+
+        //Stage 2 - solution
+        backSubstitution(tmp2, result);
+        delete copy;
+    }
+    if(index > 0)
+    {
+        *errors = true;
+    }
+
+    time = omp_get_wtime() - time;
+    result.timePar = time;
+
+    std::cout<<"Parallel time: "<<result.timePar<<" ("<<structureName(structure.type)<<")"<<std::endl;
+    dataLogger += "structure: ";
+    dataLogger += structureName(structure.type);
+    dataLogger += ", lower bandwidth: ";
+    dataLogger += to_string(structure.lower);
+    dataLogger += ", upper bandwidth: ";
+    dataLogger += to_string(structure.upper);
+    dataLogger += ", parallel time: ";
+    dataLogger += to_string(result.timePar);
+    dataLogger += ", ";
+    dataLogger += to_string(index);
+    dataLogger += " rows omitted in parallel part, ";
+    dataLogger += "affinity: ";
+    dataLogger += affinityName[parameters.affinity];
+    dataLogger += ", ";
+    unsigned long long moved = trafficReport(result.timePar);
+    double flops = (structure.type == structureDense) ? eliminationFlops(matrixArg->height, matrixArg->width) : 0;
+    counterReport(result.timePar, flops, (double)moved);
+
+    if(verification)
+    {
+        T difference = 0;
+        for (int i = 0; i < result.width; i++)
+        {
+            difference = max(difference, (T)abs(result.row(0)[i] - reference.row(0)[i]));
+        }
+        std::cout<<"Verification: maximum difference to the sequential solution: "<<difference<<std::endl;
+        dataLogger += "maximum difference to the sequential solution: ";
+        dataLogger += to_string(difference);
+        dataLogger += ", ";
+    }
+
+    if(index == 0)
+    {
+        std::cout<<"Gaussian elimination: OK"<<std::endl;
+        dataLogger += "...OK";
+    }
+    else
+    {
+        std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
+        dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+    }
+    *errors = false;
+    parameters = saved;
+    return result;
+}
+
+//mixed precision core - float factorization of a double system refined to double accuracy, the solution is written
+//to the first row of result; returns the number of omitted rows, steps and the final residual norm are reported back
+int mixedRefinement(const cMatrixD& a, cMatrixD& result, int* steps, double* normR)
+{
+    int n = a.height;
+    cMatrix residual = cMatrix(1, n);//right-hand side of the correction, single column
+    cMatrix correction = cMatrix(n, 1);
+    double* x = result.row(0);
+
+    cMatrix lu = cMatrix(a);//float copy of the input
+    int index = luFactor(lu);
+
+    double normA = 0;//infinity norm of the coefficients for the stopping test
+    #pragma omp parallel for schedule(runtime) reduction(max:normA)
+    for (int i = 0; i < n; i++)
+    {
+        const double* rowI = a.row(i);
+        double sum = 0;
+        for (int j = 0; j < n; j++)
+        {
+            sum += abs(rowI[j]);
+        }
+        normA = max(normA, sum);
+    }
+
+    workspaceArray<double> best(n);//iterate with the smallest residual so far, the one returned
+    double bestNormR = HUGE_VAL;
+    double previousNormR = HUGE_VAL;
+    for (*steps = 0; ; (*steps)++)
+    {
+        //residual r = b - A*x in double
+        double norm = 0;
+        #pragma omp parallel for schedule(runtime) reduction(max:norm)
+        for (int i = 0; i < n; i++)
+        {
+            const double* rowI = a.row(i);
+            double r = rowI[n] - dotProduct(rowI, x, n);
+            residual.row(i)[0] = (float)r;
+            norm = max(norm, abs(r));
+        }
+        if(norm < bestNormR)
+        {
+            bestNormR = norm;
+            memcpy(best.data, x, n*sizeof(double));
+        }
+        double normX = 0;
+        for (int i = 0; i < n; i++)
+        {
+            normX = max(normX, abs(x[i]));
+        }
+        if(norm <= normX*normA*numeric_limits<double>::epsilon()*sqrt((double)n) || norm >= previousNormR
+            || *steps == maxRefinementSteps)
+        {
+            break;//converged, refinement stopped helping, or no correction left to check
+        }
+        previousNormR = norm;
+
+        luSolve(lu, residual, correction);//x = x + A^-1 r with the float factors
+        const float* d = correction.row(0);
+        for (int i = 0; i < n; i++)
+        {
+            x[i] += d[i];
+        }
+    }
+    memcpy(x, best.data, n*sizeof(double));
+    *normR = bestNormR;
+    return index;
+}
+
+//mixed precision solution - the O(n^3) factorization is done in float, then the solution is refined
+//with residuals of the double input computed in double, every step costs one O(n^2) float solve
+cMatrixD matrixMixedElimination(cMatrixD* matrixArg, bool* errors)
+{
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+
+    dataLogger += endOfLine;
+    dataLogger += "Mixed precision elimination time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", amount of equations: ";
+    dataLogger += to_string(matrixArg->height);
+    dataLogger += ", ";
+
+    if (matrixArg->errorFlag){
+        std::cout<<"Input error."<<std::endl;
+        dataLogger += "Input error.";
+        *errors = true;
+        cMatrixD result = cMatrixD(1, 1);
+        return result;
+    }
+
+    if (matrixArg->width!=(matrixArg->height)+1){
+        std::cout<<"Dimension mismatch. Elimination."<<std::endl;
+        dataLogger += "Dimension mismatch. Elimination.";
+        *errors = true;
+        cMatrixD result = cMatrixD(1, 1);
+        return result;
+    }
+
+    int n = matrixArg->height;
+    cMatrixD result = cMatrixD(n, 1);//result declaration
+    double time = omp_get_wtime();
+    int steps = 0;
+    double normR = 0;
+    int index = mixedRefinement(*matrixArg, result, &steps, &normR);
+
+    result.timePar = omp_get_wtime() - time;
+
+    std::cout<<"Mixed precision time: "<<result.timePar<<std::endl;
+    dataLogger += "mixed precision time: ";
+    dataLogger += to_string(result.timePar);
+    dataLogger += ", refinement steps: ";
+    dataLogger += to_string(steps);
+    dataLogger += ", residual norm: ";
+    dataLogger += to_string(normR);
+    dataLogger += ", ";
+    dataLogger += to_string(index);
+    dataLogger += " rows omitted, ";
+
+    if(index == 0)
+    {
+        std::cout<<"Gaussian elimination: OK"<<std::endl;
+        dataLogger += "...OK";
+    }
+    else
+    {
+        std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
+        dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+    }
+    *errors = false;
+    return result;
+}
+
+//sparse solution of a Matrix Market system - the matrix is never stored densely; columns are ordered by reverse
+//Cuthill-McKee, factored by the sparse LU with threshold pivoting and the solution is returned like the dense one
+template <typename T>
+cMatrixT<T> matrixSparseElimination(string name, bool* errors)
+{
+    dataLogger += endOfLine;
+    dataLogger += "Sparse elimination time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", file: ";
+    dataLogger += name;
+    dataLogger += ", precision: ";
+    dataLogger += (sizeof(T) == sizeof(float)) ? "float" : "double";
+    dataLogger += ", ";
+
+    sparseMatrix<T> a;
+    vector<T> b;
+    double time = omp_get_wtime();
+    profileMark start = profileClock();
+    if(!readMatrixMarket(name, &a, &b))
+    {
+        std::cout<<"Cannot read files."<<std::endl;
+        dataLogger += "Cannot read files.";
+        *errors = true;
+        cMatrixT<T> result = cMatrixT<T>(1, 1);
+        return result;
+    }
+    profileAdd(phaseLoad, start);
+    time = omp_get_wtime() - time;
+    std::cout<<"File reading: OK ("<<time<<" s, "<<a.i.size()<<" nonzeros)"<<std::endl;
+    dataLogger += "amount of equations: ";
+    dataLogger += to_string(a.n);
+    dataLogger += ", nonzeros: ";
+    dataLogger += to_string(a.i.size());
+    dataLogger += ", reading time: ";
+    dataLogger += to_string(time);
+    dataLogger += ", ";
+
+    cMatrixT<T> result = cMatrixT<T>(a.n, 1);//result declaration
+    sparseMatrix<T> l, u;
+    vector<int> pinv;
+    time = omp_get_wtime();
+    bool dissection = false;
+    vector<int> q = fillReducingOrder(a, &dissection);
+    int index = sparseFactor(a, q, &l, &u, &pinv);
+    start = profileClock();
+    sparseSolve(l, u, q, pinv, b, result.row(0));
+    profileAdd(phaseBackSubstitution, start);
+    result.timePar = omp_get_wtime() - time;
+
+    std::cout<<"Sparse time: "<<result.timePar<<", ordering: "<<(dissection ? "nested dissection" : "reverse Cuthill-McKee")
+        <<", fill: "<<l.i.size() + u.i.size() - a.n<<" nonzeros in L+U"<<std::endl;
+    dataLogger += "ordering: ";
+    dataLogger += dissection ? "nested dissection" : "reverse Cuthill-McKee";
+    dataLogger += ", sparse time: ";
+    dataLogger += to_string(result.timePar);
+    dataLogger += ", nonzeros of L+U: ";
+    dataLogger += to_string(l.i.size() + u.i.size() - a.n);
+    dataLogger += ", ";
+    dataLogger += to_string(index);
+    dataLogger += " rows omitted, ";
+
+    if(index == 0)
+    {
+        std::cout<<"Gaussian elimination: OK"<<std::endl;
+        dataLogger += "...OK";
+    }
+    else
+    {
+        std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
+        dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+    }
+    *errors = false;
+    return result;
+}
+
+template <typename T>
+bool convertFile(string sourceName, string destinationName, csvLayout layout, bool toBinary)
+{
+    cMatrixT<T> matrix = cMatrixT<T>(sourceName, layout);
+    if(matrix.errorFlag)
+    {
+        return false;
+    }
+    return toBinary ? matrix.binaryWrite(destinationName, layout) : matrix.csvWrite(destinationName, layout);
+}
+
+//converts between the text layouts and the binary format
+void fileConversion()
+{
+    int optionChosen;//chosen option
+    string sourceName;
+    string destinationName;
+
+    do{
         cout<<"*******************************"<<endl;
-        cout<<"Choose 1 to set a static scheduling:"<<endl;
-        cout<<"Choose 2 to set a dynamic scheduling:"<<endl;
-        cout<<"Choose 3 to set a guided scheduling:"<<endl;
-        cout<<"Choose 4 to set an auto scheduling:"<<endl;
+        cout<<"Choose 1 to convert an input matrix (.csv) to the binary format:"<<endl;
+        cout<<"Choose 2 to convert a result file (.csv) to the binary format:"<<endl;
+        cout<<"Choose 3 to convert a binary file to .csv:"<<endl;
+
+        cin.clear();
+        cin.ignore(10000,'\n');
+        cin>>optionChosen;
+
+        if(cin.fail() || optionChosen < 1 || optionChosen > 3){
+            cout<<"Choose a correct value."<<endl;
+            continue;
+        }
+        break;
+    }while(1);
+
+    cout<<"Enter the source file name:"<<endl;
+    cin>>sourceName;
+    cout<<"Enter the destination file name:"<<endl;
+    cin>>destinationName;
+
+    dataLogger += endOfLine;
+    dataLogger += "File conversion: ";
+    dataLogger += sourceName;
+    dataLogger += " to ";
+    dataLogger += destinationName;
+    dataLogger += ", time: ";
+    dataLogger += currentDateTime();
+    dataLogger += "...";
+
+    bool done = false;
+    if(optionChosen == 3)//the binary file knows its scalar type and layout
+    {
+        binaryHeader header;
+        ifstream sourceFile(sourceName, ios::binary);
+        sourceFile.read((char*)&header, sizeof(header));
+        if(!sourceFile.fail() && memcmp(header.magic, "GEMB", 4) == 0 && header.layout >= layoutAugmented && header.layout <= layoutResult)
+        {
+            csvLayout layout = (csvLayout)header.layout;
+            done = (header.scalarSize == sizeof(double)) ? convertFile<double>(sourceName, destinationName, layout, false)
+                : convertFile<float>(sourceName, destinationName, layout, false);
+        }
+    }
+    else
+    {
+        csvLayout layout = (optionChosen == 1) ? layoutAugmented : layoutResult;
+        done = (precision == precisionFloat) ? convertFile<float>(sourceName, destinationName, layout, true)
+            : convertFile<double>(sourceName, destinationName, layout, true);
+    }
+
+    if(done)
+    {
+        cout<<"File conversion: OK"<<endl;
+        dataLogger += " OK";
+    }
+    else
+    {
+        cout<<"Error."<<endl;
+        dataLogger += " Error.";
+    }
+}
+
+//*************benchmark*******************************
+
+enum systemKind{systemRandom, systemDominant, systemKms};
+
+//synthetic n x (n+1) system with the known solution x_i = (i%7)-3+0.5, rows are seeded independently
+//so the contents do not depend on the number of threads
+//random - uniform entries in [-1,1], dominant - random with a strictly dominant diagonal,
+//kms - Kac-Murdock-Szego matrix 0.5^|i-j|, symmetric positive definite and well-conditioned
+void generateSystem(cMatrixD& a, systemKind kind, unsigned seed)
+{
+    int n = a.height;
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++)
+    {
+        double* rowI = a.row(i);
+        mt19937 generator(seed + 7919u*(unsigned)i);
+        uniform_real_distribution<double> uniform(-1.0, 1.0);
+        double b = 0;
+        for (int j = 0; j < n; j++)
+        {
+            double value = (kind == systemKms) ? pow(0.5, abs(i - j)) : uniform(generator);
+            if(kind == systemDominant && i == j)
+            {
+                value += (value < 0 ? -n : n);
+            }
+            rowI[j] = value;
+            b += value*((j%7)-3+0.5);
+        }
+        rowI[n] = b;
+    }
+}
+
+//relative residual ||b - Ax|| / (||A|| ||x||) in the infinity norm, computed in double against the generated system
+template <typename T>
+double relativeResidual(const cMatrixD& a, const cMatrixT<T>& result)
+{
+    int n = a.height;
+    workspaceArray<double> x(n);
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = result.row(0)[i];
+    }
+    double normR = 0, normA = 0, normX = 0;
+    #pragma omp parallel for schedule(static) reduction(max:normR,normA)
+    for (int i = 0; i < n; i++)
+    {
+        const double* rowI = a.row(i);
+        double sum = 0;
+        for (int j = 0; j < n; j++)
+        {
+            sum += abs(rowI[j]);
+        }
+        normA = max(normA, sum);
+        normR = max(normR, abs(rowI[n] - dotProduct(rowI, x.data, n)));
+    }
+    for (int i = 0; i < n; i++)
+    {
+        normX = max(normX, abs(x[i]));
+    }
+    return normR/max(normA*normX, numeric_limits<double>::min());
+}
+
+enum benchmarkPath{pathSequential, pathRow, pathBlocked, pathTask, pathBlockedDouble, pathMixed, pathCount};
+const char* benchmarkPathName[pathCount] = {"sequential", "row", "blocked", "task graph", "blocked double", "mixed"};
+
+struct benchmarkResult{
+    int size;
+    string path;
+    double median, p95, gflops, speedup, residual;
+    int omitted;
+};
+
+//one timed solve of a fresh copy of the system (the copy is not timed)
+template <typename T>
+double benchmarkSolve(const cMatrixD& system, benchmarkPath path, double* residual, int* omitted)
+{
+    cMatrixT<T> tmp = cMatrixT<T>(system);
+    cMatrixT<T> result = cMatrixT<T>(system.height, 1);
+    double time = omp_get_wtime();
+    if(path == pathSequential)
+    {
+        *omitted = sequentialElimination(tmp, result);
+    }
+    else
+    {
+        *omitted = luFactor(tmp);
+        backSubstitution(tmp, result);
+    }
+    time = omp_get_wtime() - time;
+    *residual = relativeResidual(system, result);
+    return time;
+}
+
+double benchmarkMixed(const cMatrixD& system, double* residual, int* omitted)
+{
+    cMatrixD result = cMatrixD(system.height, 1);
+    int steps = 0;
+    double normR = 0;
+    double time = omp_get_wtime();
+    *omitted = mixedRefinement(system, result, &steps, &normR);
+    time = omp_get_wtime() - time;
+    *residual = relativeResidual(system, result);
+    return time;
+}
+
+//runs every solver path on generated systems of the given sizes: warmup runs are discarded, then median and p95
+//of the trials, GFLOP/s of the 2/3*n^3 elimination, speedup over the sequential path and the relative residual
+//are reported and written to <outputName>.csv and <outputName>.json
+int benchmarkMode(vector<int> sizes, systemKind kind, int warmup, int trials, string outputName)
+{
+    silentMode = true;
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+    parallelParam saved = parameters;
+    vector<benchmarkResult> results;
+
+    cout<<"Benchmark: kernels "<<kernels.name<<", threads "<<parameters.wantedThreads<<", warmup "<<warmup
+        <<", trials "<<trials<<endl;
+    for (size_t s = 0; s < sizes.size(); s++)
+    {
+        int n = sizes[s];
+        cMatrixD system = cMatrixD(n + 1, n);
+        generateSystem(system, kind, 12345u + n);
+        double sequentialMedian = 0;
+
+        for (int p = 0; p < pathCount; p++)
+        {
+            benchmarkPath path = (benchmarkPath)p;
+            parameters.taskGraph = (path == pathTask);
+            parameters.blockSize = (path == pathRow) ? 0 : saved.blockSize;
+
+            vector<double> times;
+            double residual = 0;
+            int omitted = 0;
+            for (int t = 0; t < warmup + trials; t++)
+            {
+                double time;
+                if(path == pathMixed)
+                {
+                    time = benchmarkMixed(system, &residual, &omitted);
+                }
+                else if(path == pathBlockedDouble)
+                {
+                    time = benchmarkSolve<double>(system, path, &residual, &omitted);
+                }
+                else
+                {
+                    time = benchmarkSolve<float>(system, path, &residual, &omitted);
+                }
+                if(t >= warmup)
+                {
+                    times.push_back(time);
+                }
+            }
+            sort(times.begin(), times.end());
+
+            benchmarkResult r;
+            r.size = n;
+            r.path = benchmarkPathName[p];
+            r.median = (trials%2) ? times[trials/2] : (times[trials/2 - 1] + times[trials/2])/2;
+            r.p95 = times[min(trials - 1, (int)ceil(0.95*trials) - 1)];//nearest rank
+            r.gflops = 2.0/3.0*n*(double)n*n/r.median*1e-9;
+            if(path == pathSequential)
+            {
+                sequentialMedian = r.median;
+            }
+            r.speedup = sequentialMedian/r.median;
+            r.residual = residual;
+            r.omitted = omitted;
+            results.push_back(r);
+
+            cout<<"n = "<<n<<", "<<r.path<<": median "<<r.median<<" s, p95 "<<r.p95<<" s, "<<r.gflops<<" GFLOP/s, speedup "
+                <<r.speedup<<", residual "<<r.residual<<(omitted > 0 ? ", rows omitted" : "")<<endl;
+        }
+    }
+    parameters = saved;
+    silentMode = false;
+
+    ofstream csvFile(outputName + ".csv");
+    csvFile<<"equations;path;median time;p95 time;GFLOP/s;speedup;residual;omitted rows"<<endOfLine;
+    for (size_t r = 0; r < results.size(); r++)
+    {
+        csvFile<<results[r].size<<";"<<results[r].path<<";"<<results[r].median<<";"<<results[r].p95<<";"<<results[r].gflops
+            <<";"<<results[r].speedup<<";"<<results[r].residual<<";"<<results[r].omitted<<endOfLine;
+    }
+
+    ofstream jsonFile(outputName + ".json");
+    jsonFile<<"{\"time\": \""<<currentDateTime()<<"\", \"kernels\": \""<<kernels.name<<"\", \"threads\": "<<parameters.wantedThreads
+        <<", \"block size\": "<<parameters.blockSize<<", \"warmup\": "<<warmup<<", \"trials\": "<<trials<<", \"results\": ["<<endOfLine;
+    for (size_t r = 0; r < results.size(); r++)
+    {
+        jsonFile<<"  {\"equations\": "<<results[r].size<<", \"path\": \""<<results[r].path<<"\", \"median\": "<<results[r].median
+            <<", \"p95\": "<<results[r].p95<<", \"gflops\": "<<results[r].gflops<<", \"speedup\": "<<results[r].speedup
+            <<", \"residual\": "<<results[r].residual<<", \"omitted\": "<<results[r].omitted<<"}"
+            <<(r + 1 < results.size() ? "," : "")<<endOfLine;
+    }
+    jsonFile<<"]}"<<endOfLine;
+
+    bool failed = !csvFile || !jsonFile;
+    cout<<"Benchmark results: "<<outputName<<".csv, "<<outputName<<".json"<<(failed ? " - cannot write files." : "")<<endl;
+    dataLogger += endOfLine;
+    dataLogger += "Benchmark run: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", systems: ";
+    dataLogger += to_string(sizes.size());
+    dataLogger += ", results: ";
+    dataLogger += outputName;
+    updateDataLog();
+    profileWrite("benchmark");
+    return failed ? 1 : 0;
+}
+
+//*************small fixed-size systems*******************************
+
+const int fixedMaximum = 16;//systems up to this many equations are solved by the fixed-size engine
+const int fixedLanes = 16;//systems interleaved in one group, one SIMD lane each
+const int fixedPoolGroups = 64;//distinct generated groups of the throughput mode, reused round robin
+
+//elimination with partial pivoting and back substitution of a group of fixedLanes systems of N equations
+//stored as structure of arrays: a[(i*(N+1) + j)*fixedLanes + lane] is element j of row i of system lane,
+//the solutions go to x[i*fixedLanes + lane]; all bounds are constants, so the loops over rows and columns
+//unroll and every operation on the lanes is one vector instruction; rows are exchanged lane by lane by
+//selects, a zero pivot leaves its column untouched and is counted in omitted like in the other engines
+template <typename T, int N>
+inline __attribute__((always_inline)) void fixedEliminate(T* __restrict a, T* __restrict x, int* omitted)
+{
+    T (*m)[N + 1][fixedLanes] = (T (*)[N + 1][fixedLanes])a;
+    T (*y)[fixedLanes] = (T (*)[fixedLanes])x;
+    for (int l = 0; l < fixedLanes; l++)
+    {
+        omitted[l] = 0;
+    }
+
+    for (int k = 0; k < N; k++)
+    {
+        for (int r = k + 1; r < N; r++)//the first largest |element| of column k moves up to row k
+        {
+            for (int c = N; c >= k; c--)//column k is exchanged last, so the comparison holds for the whole row
+            {
+                #pragma omp simd
+                for (int l = 0; l < fixedLanes; l++)
+                {
+                    T u = m[k][c][l];
+                    T v = m[r][c][l];
+                    bool larger = abs(m[r][k][l]) > abs(m[k][k][l]);
+                    m[k][c][l] = larger ? v : u;
+                    m[r][c][l] = larger ? u : v;
+                }
+            }
+        }
+
+        T inverse[fixedLanes];
+        #pragma omp simd
+        for (int l = 0; l < fixedLanes; l++)
+        {
+            T pivot = m[k][k][l];
+            omitted[l] += (pivot == 0);
+            inverse[l] = (pivot == 0) ? 0 : 1/pivot;
+        }
+        for (int r = k + 1; r < N; r++)
+        {
+            T multiplier[fixedLanes];
+            #pragma omp simd
+            for (int l = 0; l < fixedLanes; l++)
+            {
+                multiplier[l] = m[r][k][l]*inverse[l];
+            }
+            for (int c = k + 1; c <= N; c++)
+            {
+                #pragma omp simd
+                for (int l = 0; l < fixedLanes; l++)
+                {
+                    m[r][c][l] -= multiplier[l]*m[k][c][l];
+                }
+            }
+        }
+    }
+
+    for (int i = N - 1; i >= 0; i--)
+    {
+        #pragma omp simd
+        for (int l = 0; l < fixedLanes; l++)
+        {
+            y[i][l] = m[i][N][l];
+        }
+        for (int j = i + 1; j < N; j++)
+        {
+            #pragma omp simd
+            for (int l = 0; l < fixedLanes; l++)
+            {
+                y[i][l] -= m[i][j][l]*y[j][l];
+            }
+        }
+        #pragma omp simd
+        for (int l = 0; l < fixedLanes; l++)
+        {
+            y[i][l] /= m[i][i][l];
+        }
+    }
+}
+
+//copies of the group solver for every instruction set, picked by the kernels chosen at startup
+template <typename T, int N>
+void fixedSolveBase(T* a, T* x, int* omitted){ fixedEliminate<T, N>(a, x, omitted); }
+
+#ifdef GAUSS_X86_KERNELS
+template <typename T, int N>
+__attribute__((target("avx2,fma")))
+void fixedSolveAvx2(T* a, T* x, int* omitted){ fixedEliminate<T, N>(a, x, omitted); }
+
+template <typename T, int N>
+__attribute__((target("avx512f")))
+void fixedSolveAvx512(T* a, T* x, int* omitted){ fixedEliminate<T, N>(a, x, omitted); }
+#endif
+
+//solves a group of systems of n equations with the instance for n, false when n is larger than fixedMaximum
+template <typename T, int N = 1>
+bool fixedSolve(int n, T* a, T* x, int* omitted)
+{
+    if constexpr (N > fixedMaximum)
+    {
+        return false;
+    }
+    else
+    {
+        if(n != N)
+        {
+            return fixedSolve<T, N + 1>(n, a, x, omitted);
+        }
+#ifdef GAUSS_X86_KERNELS
+        if(kernels.isa == isaAvx512)
+        {
+            fixedSolveAvx512<T, N>(a, x, omitted);
+            return true;
+        }
+        if(kernels.isa == isaAvx2)
+        {
+            fixedSolveAvx2<T, N>(a, x, omitted);
+            return true;
+        }
+#endif
+        fixedSolveBase<T, N>(a, x, omitted);
+        return true;
+    }
+}
+
+//throughput of the fixed-size engine: count systems of every size are solved in groups of fixedLanes,
+//copied from a pool of generated groups, and a part of them one by one through the general path for comparison
+template <typename T>
+int tinyMode(vector<int> sizes, int count)
+{
+    silentMode = true;
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+    omp_set_max_active_levels(1);//the general path of one system stays on its thread
+    bool failed = false;
+
+    cout<<"Small systems: kernels "<<kernels.name<<", threads "<<parameters.wantedThreads<<", systems per size "<<count
+        <<(sizeof(T) == sizeof(double) ? ", double" : ", float")<<endl;
+    for (size_t s = 0; s < sizes.size(); s++)
+    {
+        int n = sizes[s];
+        if(n < 1 || n > fixedMaximum)
+        {
+            cout<<"n = "<<n<<": only 1 to "<<fixedMaximum<<" equations are supported."<<endl;
+            failed = true;
+            continue;
+        }
+        size_t groupSize = (size_t)n*(n + 1)*fixedLanes;
+        vector<T> pool(groupSize*fixedPoolGroups);
+        for (int g = 0; g < fixedPoolGroups; g++)
+        {
+            mt19937 generator(12345u + 7919u*(unsigned)(g*fixedMaximum + n));
+            uniform_real_distribution<double> uniform(-1.0, 1.0);
+            T* group = pool.data() + g*groupSize;
+            for (int l = 0; l < fixedLanes; l++)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    double b = 0;
+                    for (int j = 0; j < n; j++)
+                    {
+                        T value = (T)uniform(generator);
+                        group[(i*(n + 1) + j)*fixedLanes + l] = value;
+                        b += value*((j%7)-3+0.5);
+                    }
+                    group[(i*(n + 1) + n)*fixedLanes + l] = (T)b;
+                }
+            }
+        }
+
+        //fixed-size engine
+        int groups = (count + fixedLanes - 1)/fixedLanes;
+        int omitted = 0;
+        double time = omp_get_wtime();
+        #pragma omp parallel reduction(+:omitted)
+        {
+            alignas(matrixAlignment) T a[fixedMaximum*(fixedMaximum + 1)*fixedLanes];
+            alignas(matrixAlignment) T x[fixedMaximum*fixedLanes];
+            int groupOmitted[fixedLanes];
+            #pragma omp for schedule(static)
+            for (int g = 0; g < groups; g++)
+            {
+                memcpy(a, pool.data() + (g%fixedPoolGroups)*groupSize, groupSize*sizeof(T));
+                fixedSolve(n, a, x, groupOmitted);
+                for (int l = 0; l < fixedLanes; l++)
+                {
+                    omitted += (groupOmitted[l] > 0);
+                }
+            }
+        }
+        double fixedTime = omp_get_wtime() - time;
+
+        //relative residual of every pool system, in double
+        double residual = 0;
+        for (int g = 0; g < fixedPoolGroups; g++)
+        {
+            T a[fixedMaximum*(fixedMaximum + 1)*fixedLanes];
+            T x[fixedMaximum*fixedLanes];
+            int groupOmitted[fixedLanes];
+            const T* group = pool.data() + g*groupSize;
+            memcpy(a, group, groupSize*sizeof(T));
+            fixedSolve(n, a, x, groupOmitted);
+            for (int l = 0; l < fixedLanes; l++)
+            {
+                double normR = 0, normA = 0, normX = 0;
+                for (int i = 0; i < n; i++)
+                {
+                    double sum = 0, r = group[(i*(n + 1) + n)*fixedLanes + l];
+                    for (int j = 0; j < n; j++)
+                    {
+                        double value = group[(i*(n + 1) + j)*fixedLanes + l];
+                        sum += abs(value);
+                        r -= value*x[j*fixedLanes + l];
+                    }
+                    normA = max(normA, sum);
+                    normR = max(normR, abs(r));
+                    normX = max(normX, (double)abs(x[i*fixedLanes + l]));
+                }
+                residual = max(residual, normR/max(normA*normX, 1e-300));
+            }
+        }
+
+        //general path - a matrix per system, factorization and back substitution as in the batch mode
+        int sample = min(count, fixedPoolGroups*fixedLanes);
+        time = omp_get_wtime();
+        #pragma omp parallel for schedule(static)
+        for (int e = 0; e < sample; e++)
+        {
+            const T* group = pool.data() + (e/fixedLanes)*groupSize;
+            int l = e%fixedLanes;
+            cMatrixT<T> system = cMatrixT<T>(n + 1, n);
+            for (int i = 0; i < n; i++)
+            {
+                for (int j = 0; j <= n; j++)
+                {
+                    system.row(i)[j] = group[(i*(n + 1) + j)*fixedLanes + l];
+                }
+            }
+            cMatrixT<T> result = cMatrixT<T>(n, 1);
+            luFactor(system);
+            backSubstitution(system, result);
+        }
+        double generalTime = omp_get_wtime() - time;
+
+        double fixedRate = groups*fixedLanes/max(fixedTime, 1e-9);
+        double generalRate = sample/max(generalTime, 1e-9);
+        cout<<"n = "<<n<<": fixed-size "<<fixedRate<<" systems/s, general "<<generalRate<<" systems/s, speedup "
+            <<fixedRate/generalRate<<", residual "<<residual<<(omitted > 0 ? ", rows omitted" : "")<<endl;
+        dataLogger += endOfLine;
+        dataLogger += "Small systems run: ";
+        dataLogger += currentDateTime();
+        dataLogger += ", amount of equations: ";
+        dataLogger += to_string(n);
+        dataLogger += ", systems: ";
+        dataLogger += to_string(groups*fixedLanes);
+        dataLogger += ", fixed-size systems per second: ";
+        dataLogger += to_string(fixedRate);
+        dataLogger += ", general systems per second: ";
+        dataLogger += to_string(generalRate);
+    }
+    silentMode = false;
+    updateDataLog();
+    return failed ? 1 : 0;
+}
+
+//*************autotuning*******************************
+
+//median time of a float solve of the system with the current parameters
+double tuningTime(const cMatrixD& system, int trials)
+{
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+    vector<double> times;
+    double residual = 0;
+    int omitted = 0;
+    benchmarkSolve<float>(system, pathBlocked, &residual, &omitted);//warmup
+    for (int t = 0; t < trials; t++)
+    {
+        times.push_back(benchmarkSolve<float>(system, pathBlocked, &residual, &omitted));
+    }
+    sort(times.begin(), times.end());
+    return times[trials/2];
+}
+
+//sweeps the parallel parameters on generated systems of the given sizes and stores the fastest per size class
+//in the tuning cache; the sweep is staged to stay short - engine and block size first, then schedule and chunk
+//size for the chosen engine, then the number of threads
+int autotuneMode(vector<int> sizes, int trials)
+{
+    silentMode = true;
+    parallelParam saved = parameters;
+    int processors = omp_get_num_procs();
+    vector<tuningEntry> entries = readTuningCache();
+    string host = tuningHost();
+
+    vector<int> threadCounts;
+    for (int t = 1; t < processors; t *= 2)
+    {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(processors);
+    omp_sched_t schedules[] = { omp_sched_static, omp_sched_dynamic, omp_sched_guided, omp_sched_auto };
+    int chunks[] = { 1, 8, 32, 128 };
+    int blocks[] = { 32, 64, 128, 256 };
+
+    cout<<"Autotuning on "<<host<<", "<<processors<<" processors, trials "<<trials<<endl;
+    for (size_t s = 0; s < sizes.size(); s++)
+    {
+        int n = sizes[s];
+        cMatrixD system = cMatrixD(n + 1, n);
+        generateSystem(system, systemRandom, 12345u + n);
+
+        parallelParam best = { omp_sched_dynamic, 8, processors, 1, false, parameters.affinity };
+        parameters = best;
+        double bestTime = tuningTime(system, trials);//row engine
+
+        for (int task = 0; task < 2; task++)//blocked and task graph engines
+        {
+            for (int b = 0; b < 4 && blocks[b] < n; b++)
+            {
+                parameters = best;
+                parameters.taskGraph = (task != 0);
+                parameters.blockSize = blocks[b];
+                double time = tuningTime(system, trials);
+                if(time < bestTime)
+                {
+                    bestTime = time;
+                    best = parameters;
+                }
+            }
+        }
+
+        for (int k = 0; k < 4; k++)
+        {
+            for (int c = 0; c < 4 && (c == 0 || schedules[k] != omp_sched_auto); c++)//auto ignores the chunk size
+            {
+                parameters = best;
+                parameters.scheduleType = schedules[k];
+                parameters.chunkSize = chunks[c];
+                double time = tuningTime(system, trials);
+                if(time < bestTime)
+                {
+                    bestTime = time;
+                    best = parameters;
+                }
+            }
+        }
+
+        for (size_t t = 0; t + 1 < threadCounts.size(); t++)//the processor count was measured already
+        {
+            parameters = best;
+            parameters.wantedThreads = threadCounts[t];
+            double time = tuningTime(system, trials);
+            if(time < bestTime)
+            {
+                bestTime = time;
+                best = parameters;
+            }
+        }
+
+        tuningEntry entry = { host, sizeBucket(n), best, bestTime };
+        size_t e = 0;
+        while(e < entries.size() && !(entries[e].host == host && entries[e].bucket == entry.bucket))
+        {
+            e++;
+        }
+        if(e < entries.size())
+        {
+            entries[e] = entry;
+        }
+        else
+        {
+            entries.push_back(entry);
+        }
+
+        cout<<"n = "<<n<<" (up to "<<entry.bucket<<"): "<<(best.taskGraph ? "task graph" : best.blockSize > 1 ? "blocked" : "row")
+            <<", block "<<best.blockSize<<", schedule "<<(int)best.scheduleType<<", chunk "<<best.chunkSize
+            <<", threads "<<best.wantedThreads<<", time "<<bestTime<<endl;
+    }
+    parameters = saved;
+    silentMode = false;
+
+    bool written = writeTuningCache(entries);
+    cout<<(written ? "Tuning cache written: " : "Cannot write files: ")<<tuningCacheName<<endl;
+    dataLogger += endOfLine;
+    dataLogger += "Autotuning: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", sizes: ";
+    dataLogger += to_string(sizes.size());
+    dataLogger += written ? ", cache written" : ", cannot write the cache";
+    updateDataLog();
+    profileWrite("autotune");
+    return written ? 0 : 1;
+}
+
+//*************out-of-core elimination*******************************
+
+const int outOfCoreBudget = 1024;//default memory budget of the out-of-core mode in MB
+
+const char* outOfCoreScratch = "OutOfCore.tmp";//panel file, removed as soon as it is opened
+
+bool readFully(int file, void* buffer, size_t bytes, off_t offset)
+{
+    char* p = (char*)buffer;
+    while(bytes > 0)
+    {
+        ssize_t done = pread(file, p, bytes, offset);
+        if(done <= 0)
+        {
+            return false;
+        }
+        p += done;
+        bytes -= done;
+        offset += done;
+    }
+    return true;
+}
+
+bool writeFully(int file, const void* buffer, size_t bytes, off_t offset)
+{
+    const char* p = (const char*)buffer;
+    while(bytes > 0)
+    {
+        ssize_t done = pwrite(file, p, bytes, offset);
+        if(done <= 0)
+        {
+            return false;
+        }
+        p += done;
+        bytes -= done;
+        offset += done;
+    }
+    return true;
+}
+
+//augmented matrix read a block of rows at a time, from the binary format or from the text,
+//so that a matrix larger than memory never has to be held whole
+struct rowSource{
+    int file;
+    bool binary;
+    int height, width, ld, scalarSize;
+    const char* text;//mapped text, already parsed pages are given back
+    size_t textSize;
+    const char* cursor;
+    size_t released;
+    int rowsRead;
+};
+
+bool openRowSource(string name, rowSource* source)
+{
+    source->file = open(name.c_str(), O_RDONLY);
+    source->text = NULL;
+    source->rowsRead = 0;
+    struct stat fileInfo;
+    if(source->file < 0 || fstat(source->file, &fileInfo) != 0 || fileInfo.st_size == 0)
+    {
+        return false;
+    }
+    binaryHeader header;
+    source->binary = readFully(source->file, &header, sizeof(header), 0) && memcmp(header.magic, "GEMB", 4) == 0;
+    if(source->binary)
+    {
+        source->height = header.height;
+        source->width = header.width;
+        source->ld = header.ld;
+        source->scalarSize = header.scalarSize;
+        return header.version == binaryVersion && !header.hasPermutation && header.height > 0
+            && header.width == header.height + 1 && header.ld >= header.width
+            && (header.scalarSize == sizeof(float) || header.scalarSize == sizeof(double))
+            && (size_t)fileInfo.st_size >= sizeof(header) + (size_t)header.height*header.ld*header.scalarSize;
+    }
+
+    source->textSize = fileInfo.st_size;
+    void* mapped = mmap(NULL, source->textSize, PROT_READ, MAP_PRIVATE, source->file, 0);
+    if(mapped == MAP_FAILED)
+    {
+        return false;
+    }
+    madvise(mapped, source->textSize, MADV_SEQUENTIAL);
+    source->text = (const char*)mapped;
+    source->released = 0;
+    const char* end = source->text + source->textSize;
+    const char* p = source->text;
+    while(p < end && isspace((unsigned char)*p))
+    {
+        p++;
+    }
+    if(from_chars(p, end, source->height).ec != errc() || source->height < 1)
+    {
+        return false;
+    }
+    source->width = source->ld = source->height + 1;
+    source->cursor = (const char*)memchr(p, '\n', end - p);
+    return source->cursor != NULL;
+}
+
+void closeRowSource(rowSource* source)
+{
+    if(source->text != NULL)
+    {
+        munmap((void*)source->text, source->textSize);
+    }
+    if(source->file >= 0)
+    {
+        close(source->file);
+    }
+}
+
+//bytes of one stored row of a binary source, 0 for text
+size_t sourceRowBytes(const rowSource& source)
+{
+    return source.binary ? (size_t)source.ld*source.scalarSize : 0;
+}
+
+//reads the next count rows into rows, stride elements apart; binary rows are read into staging first,
+//which holds count*sourceRowBytes bytes
+template <typename T>
+bool readSourceRows(rowSource* source, int count, T* rows, size_t stride, char* staging)
+{
+    if(source->binary)
+    {
+        size_t rowBytes = sourceRowBytes(*source);
+        if(!readFully(source->file, staging, (size_t)count*rowBytes, sizeof(binaryHeader) + (size_t)source->rowsRead*rowBytes))
+        {
+            return false;
+        }
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < count; i++)
+        {
+            const char* rowI = staging + (size_t)i*rowBytes;
+            for (int j = 0; j < source->width; j++)
+            {
+                rows[(size_t)i*stride + j] = (source->scalarSize == sizeof(float)) ? (T)((const float*)rowI)[j]
+                    : (T)((const double*)rowI)[j];
+            }
+        }
+        source->rowsRead += count;
+        return true;
+    }
+
+    //line boundaries first, then the lines are parsed in parallel as in readCsv
+    const char* end = source->text + source->textSize;
+    vector<const char*> lineStart(count + 1);
+    const char* p = source->cursor;
+    for (int i = 0; i < count; i++)
+    {
+        if(p == NULL || p + 1 >= end)
+        {
+            return false;
+        }
+        lineStart[i] = ++p;
+        p = (const char*)memchr(p, '\n', end - p);
+    }
+    lineStart[count] = (p != NULL) ? p : end;
+    source->cursor = p;
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; i++)
+    {
+        T* rowI = rows + (size_t)i*stride;
+        const char* field = lineStart[i];
+        const char* lineEnd = lineStart[i + 1];
+        for (int j = 0; j < source->width; j++)
+        {
+            if(field >= lineEnd)//missing values are read as 0
+            {
+                rowI[j] = 0;
+                continue;
+            }
+            const char* next = (const char*)memchr(field, ';', lineEnd - field);
+            const char* fieldEnd = (next != NULL) ? next : lineEnd;
+            parseValue(field, fieldEnd, rowI + j);
+            field = (next != NULL) ? next + 1 : lineEnd;
+        }
+    }
+
+    //parsed pages are dropped from the mapping so the text does not stay resident
+    size_t parsed = ((lineStart[count] - source->text) / 4096) * 4096;
+    if(parsed > source->released)
+    {
+        madvise((void*)(source->text + source->released), parsed - source->released, MADV_DONTNEED);
+        source->released = parsed;
+    }
+    source->rowsRead += count;
+    return true;
+}
+
+//left-looking LU of the column panels of the scratch file - every panel is updated with all panels to its left,
+//which are streamed through two buffers with the next one prefetched, then factored with partial pivoting and
+//written back while the next panel is read; panels hold all n rows of blockSize columns, rows in physical
+//order, and the row permutation is kept in memory
+//returns the number of omitted rows, -1 when the scratch file cannot be read or written
+template <typename T>
+int outOfCoreFactor(int scratch, int n, int width, int blockSize, vector<int>& perm, vector<T*>& current, vector<T*>& stream)
+{
+    int panels = (width + blockSize - 1)/blockSize;
+    size_t panelBytes = (size_t)n*blockSize*sizeof(T);
+    int index = 0;
+    future<bool> load = async(launch::async, readFully, scratch, (void*)current[0], panelBytes, (off_t)0);
+    future<bool> write;
+    future<bool> prefetch;
+
+    for (int k = 0; k < panels; k++)
+    {
+        T* panel = current[k%2];
+        int k0 = k*blockSize;
+        int cols = min(blockSize, width - k0);
+        if(!load.get())
+        {
+            return -1;
+        }
+
+        //update with the factored panels to the left, the previous one is still in memory
+        if(k > 1)
+        {
+            prefetch = async(launch::async, readFully, scratch, (void*)stream[0], panelBytes, (off_t)0);
+        }
+        for (int j = 0; j < k; j++)
+        {
+            const T* left = current[(k - 1)%2];
+            if(j < k - 1)
+            {
+                if(!prefetch.get())
+                {
+                    return -1;
+                }
+                left = stream[j%2];
+                if(j + 1 < k - 1)
+                {
+                    prefetch = async(launch::async, readFully, scratch, (void*)stream[(j + 1)%2], panelBytes, (off_t)((j + 1)*panelBytes));
+                }
+            }
+            int j0 = j*blockSize;
+            int j1 = j0 + blockSize;
+
+            profileMark start = profileClock();
+            for (int i = j0; i < j1; i++)//rows of U - solved with the unit lower triangle of the left panel
+            {
+                const T* rowI = panel + (size_t)perm[i]*blockSize;
+                #pragma omp parallel for schedule(static)
+                for (int r = i + 1; r < j1; r++)
+                {
+                    T* rowR = panel + (size_t)perm[r]*blockSize;
+                    rowUpdate(rowR, rowI, left[(size_t)perm[r]*blockSize + i - j0], cols);
+                }
+            }
+            profileAdd(phasePanel, start);
+
+            start = profileClock();
+            #pragma omp parallel for schedule(runtime)
+            for (int r = j1; r < n; r++)//rows below - A = A - L*U
+            {
+                T* rowR = panel + (size_t)perm[r]*blockSize;
+                const T* multipliers = left + (size_t)perm[r]*blockSize;
+                for (int p = 0; p < blockSize; p++)
+                {
+                    rowUpdate(rowR, panel + (size_t)perm[j0 + p]*blockSize, multipliers[p], cols);
+                }
+            }
+            profileAdd(phaseTrailingUpdate, start);
+        }
+
+        //panel factorization, the right-hand side column of the last panel takes no pivot
+        profileMark start = profileClock();
+        for (int c = 0; c < cols && k0 + c < n; c++)
+        {
+            int g = k0 + c;
+            int p = g + (((size_t)n*blockSize > INT_MAX) ? maxAbsScalar(panel + c, perm.data() + g, blockSize, n - g)
+                : maxAbs(panel + c, perm.data() + g, blockSize, n - g));
+            swap(perm[g], perm[p]);
+            const T* rowG = panel + (size_t)perm[g]*blockSize;
+            if(rowG[c] == 0)//rows with maximum element equal to 0 are omitted
+            {
+                index++;
+                continue;
+            }
+            T inverse = 1/rowG[c];
+            #pragma omp parallel for schedule(runtime)
+            for (int r = g + 1; r < n; r++)
+            {
+                T* rowR = panel + (size_t)perm[r]*blockSize;
+                T multiplier = rowR[c]*inverse;
+                rowR[c] = multiplier;
+                rowUpdate(rowR + c + 1, rowG + c + 1, multiplier, cols - c - 1);
+            }
+        }
+        profileAdd(phasePanel, start);
+
+        //write-back of this panel overlaps with the reading of the next one
+        if(write.valid() && !write.get())
+        {
+            return -1;
+        }
+        write = async(launch::async, writeFully, scratch, (const void*)panel, panelBytes, (off_t)(k*panelBytes));
+        if(k + 1 < panels)
+        {
+            load = async(launch::async, readFully, scratch, (void*)current[(k + 1)%2], panelBytes, (off_t)((k + 1)*panelBytes));
+        }
+    }
+    if(write.valid() && !write.get())
+    {
+        return -1;
+    }
+    return index;
+}
+
+//solves an augmented system that does not have to fit into memory: the rows are copied into a scratch file of
+//column panels sized to the memory budget, factored panel by panel and solved by a column-oriented back
+//substitution streaming the panels back from the last one; the solution is printed like the in-memory one
+template <typename T>
+int outOfCoreMode(string source, int budget, string nameOutput)
+{
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+
+    dataLogger += endOfLine;
+    dataLogger += "Out-of-core elimination time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", file: ";
+    dataLogger += source;
+    dataLogger += ", memory budget: ";
+    dataLogger += to_string(budget);
+    dataLogger += " MB, ";
+
+    rowSource input;
+    if(!openRowSource(source, &input))
+    {
+        closeRowSource(&input);
+        cout<<"Cannot read files."<<endl;
+        dataLogger += "Cannot read files.";
+        updateDataLog();
+        return 1;
+    }
+    int n = input.height;
+    int width = input.width;
+
+    //four panels are in memory: two for the panel being factored and written, two for the streamed ones
+    size_t budgetBytes = (size_t)budget << 20;
+    long long fit = budgetBytes/(4*(size_t)n*sizeof(T));
+    int blockSize = (int)min((long long)width, fit >= minimumTileSize ? fit/minimumTileSize*minimumTileSize : fit);
+    if(blockSize < 1)
+    {
+        closeRowSource(&input);
+        cout<<"The memory budget is too small for "<<n<<" equations."<<endl;
+        dataLogger += "memory budget too small.";
+        updateDataLog();
+        return 1;
+    }
+    int panels = (width + blockSize - 1)/blockSize;
+    size_t panelBytes = (size_t)n*blockSize*sizeof(T);
+
+    int scratch = open(outOfCoreScratch, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if(scratch >= 0)
+    {
+        unlink(outOfCoreScratch);
+    }
+    size_t bufferBytes = max(panelBytes, max((size_t)width*sizeof(T), sourceRowBytes(input)));//a buffer takes at least one source row
+    bufferBytes = (bufferBytes + matrixAlignment - 1)/matrixAlignment*matrixAlignment;
+    vector<T*> current(2), stream(2);
+    for (int b = 0; b < 2; b++)
+    {
+        current[b] = (T*)aligned_alloc(matrixAlignment, bufferBytes);
+        stream[b] = (T*)aligned_alloc(matrixAlignment, bufferBytes);
+    }
+    cout<<"Out-of-core: "<<n<<" equations, "<<panels<<" panels of "<<blockSize<<" columns, "
+        <<(double)panels*panelBytes/(1 << 20)<<" MB on disk"<<endl;
+
+    //rows are copied into the panels a block at a time, the block uses the memory of the panel buffers -
+    //binary rows are read into one buffer, converted into the second and packed into the third
+    double time = omp_get_wtime();
+    bool failed = (scratch < 0);
+    size_t rowBytes = max((size_t)width*sizeof(T), sourceRowBytes(input));
+    int rowBlock = (int)max((size_t)1, min((size_t)n, bufferBytes/rowBytes));
+    T* rows = current[0];
+    char* staging = (char*)current[1];
+    for (int r0 = 0; r0 < n && !failed; r0 += rowBlock)
+    {
+        int count = min(rowBlock, n - r0);
+        profileMark start = profileClock();
+        failed = !readSourceRows(&input, count, rows, width, staging);
+        profileAdd(phaseLoad, start);
+        T* packed = stream[0];//count rows of one panel
+        for (int k = 0; k < panels && !failed; k++)
+        {
+            int k0 = k*blockSize;
+            int cols = min(blockSize, width - k0);
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < count; i++)
+            {
+                memcpy(packed + (size_t)i*blockSize, rows + (size_t)i*width + k0, cols*sizeof(T));
+            }
+            start = profileClock();
+            failed = !writeFully(scratch, packed, (size_t)count*blockSize*sizeof(T), (off_t)(k*panelBytes + (size_t)r0*blockSize*sizeof(T)));
+            profileAdd(phaseStore, start);
+        }
+    }
+    closeRowSource(&input);
+    double copyTime = omp_get_wtime() - time;
+
+    vector<int> perm(n);
+    for (int i = 0; i < n; i++)
+    {
+        perm[i] = i;
+    }
+    int index = 0;
+    cMatrixT<T> result = cMatrixT<T>(n, 1);
+    time = omp_get_wtime();
+    if(!failed)
+    {
+        index = outOfCoreFactor(scratch, n, width, blockSize, perm, current, stream);
+        failed = (index < 0);
+    }
+
+    //back substitution by columns from the last panel, which is still in memory, to the first
+    if(!failed)
+    {
+        profileMark start = profileClock();
+        T* x = result.row(0);
+        vector<T> y(n);
+        int last = panels - 1;
+        const T* panel = current[last%2];
+        for (int i = 0; i < n; i++)
+        {
+            y[i] = panel[(size_t)perm[i]*blockSize + (n - last*blockSize)];
+        }
+        future<bool> load;
+        for (int k = last; k >= 0 && !failed; k--)
+        {
+            if(k < last)
+            {
+                failed = !load.get();
+                panel = stream[k%2];
+            }
+            if(k > 0)
+            {
+                load = async(launch::async, readFully, scratch, (void*)stream[(k - 1)%2], panelBytes, (off_t)((k - 1)*panelBytes));
+            }
+            int k0 = k*blockSize;
+            for (int c = min(blockSize, n - k0) - 1; c >= 0 && !failed; c--)
+            {
+                int g = k0 + c;
+                T diagonal = panel[(size_t)perm[g]*blockSize + c];
+                x[g] = (diagonal == 0) ? 0 : y[g]/diagonal;
+                #pragma omp parallel for schedule(static) if(g > 4096)
+                for (int i = 0; i < g; i++)
+                {
+                    y[i] -= panel[(size_t)perm[i]*blockSize + c]*x[g];
+                }
+            }
+        }
+        if(load.valid())
+        {
+            load.get();
+        }
+        profileAdd(phaseBackSubstitution, start);
+    }
+    result.timePar = omp_get_wtime() - time;
+
+    for (int b = 0; b < 2; b++)
+    {
+        free(current[b]);
+        free(stream[b]);
+    }
+    if(scratch >= 0)
+    {
+        close(scratch);
+    }
 
-        cin.clear();
-        cin.ignore(10000,'\n');
-        cin>>optionChosen;
+    if(failed)
+    {
+        cout<<"Cannot write files."<<endl;
+        dataLogger += "Cannot read or write the scratch file.";
+        updateDataLog();
+        return 1;
+    }
 
-        if(cin.fail()){
-            cout<<"Choose a correct value."<<endl;
-            continue;
+    cout<<"Copy to panels: "<<copyTime<<" s"<<endl;
+    cout<<"Out-of-core time: "<<result.timePar<<endl;
+    dataLogger += "amount of equations: ";
+    dataLogger += to_string(n);
+    dataLogger += ", panel width: ";
+    dataLogger += to_string(blockSize);
+    dataLogger += ", copy time: ";
+    dataLogger += to_string(copyTime);
+    dataLogger += ", out-of-core time: ";
+    dataLogger += to_string(result.timePar);
+    dataLogger += ", ";
+    dataLogger += to_string(index);
+    dataLogger += " rows omitted, ";
+    if(index == 0)
+    {
+        std::cout<<"Gaussian elimination: OK"<<std::endl;
+        dataLogger += "...OK";
+    }
+    else
+    {
+        std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
+        dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+    }
+    result.mPrint(nameOutput);
+    updateDataLog();
+    profileWrite("out of core");
+    return 0;
+}
+
+//*************batch mode*******************************
+
+const int batchLargeSystem = 1500;//systems of this many equations or more are solved one at a time with all threads
+
+struct batchEntry{
+    string name;//input file
+    string outputName;
+    int height;//-1 when the file cannot be read
+    double loadTime, solveTime, writeTime;
+    int omitted;//rows omitted by the elimination
+    bool failed;
+};
+
+//amount of equations of an input file, read from its first line or binary header without loading it
+int peekHeight(string name)
+{
+    char buffer[sizeof(binaryHeader)];
+    ifstream sourceFile(name, ios::binary);
+    sourceFile.read(buffer, sizeof(buffer));
+    size_t got = sourceFile.gcount();
+    if(got >= 4 && memcmp(buffer, "GEMB", 4) == 0)
+    {
+        if(got < sizeof(binaryHeader))
+        {
+            return -1;
         }
+        binaryHeader header;
+        memcpy(&header, buffer, sizeof(header));
+        return header.height;
+    }
+    const char* p = buffer;
+    while(p < buffer + got && isspace((unsigned char)*p))
+    {
+        p++;
+    }
+    int h = -1;
+    if(from_chars(p, buffer + got, h).ec != errc())
+    {
+        return -1;
+    }
+    return h;
+}
 
-        if (optionChosen==1)
+//in-place factorization and back substitution of a loaded system, without logging
+template <typename T>
+void batchSolve(cMatrixT<T>& system, batchEntry& entry, cMatrixT<T>& result)
+{
+    double time = omp_get_wtime();
+    matrixStructure structure = findStructure(system);
+    if(structure.type != structureDense)
+    {
+        entry.omitted = structuredSolve(system, structure, result);
+    }
+    else
+    {
+        entry.omitted = luFactor(system);
+        backSubstitution(system, result);
+    }
+    entry.solveTime = omp_get_wtime() - time;
+}
+
+template <typename T>
+void batchWrite(cMatrixT<T>& result, batchEntry& entry)
+{
+    double time = omp_get_wtime();
+    entry.failed = entry.failed || !result.csvWrite(entry.outputName, layoutResult);
+    entry.writeTime = omp_get_wtime() - time;
+}
+
+template <typename T>
+cMatrixT<T>* batchLoad(batchEntry* entry)
+{
+    double time = omp_get_wtime();
+    cMatrixT<T>* system = new cMatrixT<T>(entry->name);
+    entry->loadTime = omp_get_wtime() - time;
+    if(system->errorFlag || system->width != system->height + 1)
+    {
+        entry->failed = true;
+    }
+    return system;
+}
+
+//small systems - one system per thread, the nested elimination regions run on one thread;
+//loading and writing of some threads overlap with solving on the others
+template <typename T>
+void batchSmall(vector<batchEntry*>& entries)
+{
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(parameters.wantedThreads)
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        batchEntry& entry = *entries[e];
+        cMatrixT<T>* system = batchLoad<T>(&entry);
+        if(!entry.failed)
         {
-            parameters.scheduleType = omp_sched_static;
-            break;
+            cMatrixT<T> result = cMatrixT<T>(system->height, 1);
+            batchSolve(*system, entry, result);
+            batchWrite(result, entry);
         }
-        else if (optionChosen==2)
+        delete system;
+    }
+}
+
+//tiny systems - groups of fixedLanes systems of the same size are packed side by side and solved together
+//by the fixed-size engine, every thread loads, solves and writes its own groups
+template <typename T>
+void batchTiny(vector<batchEntry*>& entries)
+{
+    stable_sort(entries.begin(), entries.end(), [](const batchEntry* a, const batchEntry* b) { return a->height < b->height; });
+    vector<size_t> groupStart;//first entry of every group, a group never mixes sizes
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        if(groupStart.empty() || e - groupStart.back() == (size_t)fixedLanes || entries[e]->height != entries[groupStart.back()]->height)
         {
-            parameters.scheduleType = omp_sched_dynamic;
-            break;
+            groupStart.push_back(e);
         }
-        else if (optionChosen==3)
+    }
+    int groups = (int)groupStart.size();
+    groupStart.push_back(entries.size());
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(parameters.wantedThreads)
+    for (int g = 0; g < groups; g++)
+    {
+        alignas(matrixAlignment) T a[fixedMaximum*(fixedMaximum + 1)*fixedLanes] = {};
+        alignas(matrixAlignment) T x[fixedMaximum*fixedLanes];
+        int omitted[fixedLanes];
+        int n = entries[groupStart[g]]->height;
+        int lanes = (int)(groupStart[g + 1] - groupStart[g]);
+        for (int l = 0; l < fixedLanes; l++)//unused lanes get an identity system
         {
-            parameters.scheduleType = omp_sched_guided;
-            break;
+            for (int i = 0; i < n; i++)
+            {
+                a[(i*(n + 1) + i)*fixedLanes + l] = 1;
+            }
         }
-        else if (optionChosen==4)
+        for (int l = 0; l < lanes; l++)
         {
-            parameters.scheduleType = omp_sched_auto;
-            break;
+            batchEntry& entry = *entries[groupStart[g] + l];
+            cMatrixT<T>* system = batchLoad<T>(&entry);
+            if(!entry.failed && system->height == n)
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    for (int j = 0; j <= n; j++)
+                    {
+                        a[(i*(n + 1) + j)*fixedLanes + l] = system->row(i)[j];
+                    }
+                }
+            }
+            else
+            {
+                entry.failed = true;
+            }
+            delete system;
         }
-        else
+
+        double time = omp_get_wtime();
+        fixedSolve(n, a, x, omitted);
+        time = (omp_get_wtime() - time)/lanes;
+
+        for (int l = 0; l < lanes; l++)
         {
-            cout<<"Choose a correct value."<<endl;
+            batchEntry& entry = *entries[groupStart[g] + l];
+            if(entry.failed)
+            {
+                continue;
+            }
+            cMatrixT<T> result = cMatrixT<T>(n, 1);
+            for (int i = 0; i < n; i++)
+            {
+                result.row(0)[i] = x[i*fixedLanes + l];
+            }
+            entry.omitted = omitted[l];
+            entry.solveTime = time;
+            batchWrite(result, entry);
         }
-    }while(1);
+    }
+}
 
-    do{
-        cout<<"Choose size of chunks:"<<endl;
-        cin.clear();
-        cin.ignore(10000,'\n');
+//large systems - one at a time with the intra-matrix parallel engine, the next input is loaded
+//and the previous result is written by helper threads while the current one is solved; the parallel
+//regions of the helpers run on their own thread, so they do not oversubscribe the solving team
+template <typename T>
+void batchLarge(vector<batchEntry*>& entries)
+{
+    if(entries.empty())
+    {
+        return;
+    }
+    auto load = [](batchEntry* entry) {
+        omp_set_num_threads(1);
+        return batchLoad<T>(entry);
+    };
+    future<cMatrixT<T>*> nextLoad = async(launch::async, load, entries[0]);
+    future<void> previousWrite;
+    cMatrixT<T>* previousResult = NULL;
 
-        cin>>optionChosen;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        batchEntry& entry = *entries[e];
+        cMatrixT<T>* system = nextLoad.get();
+        if(e + 1 < entries.size())
+        {
+            nextLoad = async(launch::async, load, entries[e + 1]);
+        }
 
-        if(cin.fail()){
-            cout<<"Choose a correct value."<<endl;
+        cMatrixT<T>* result = NULL;
+        if(!entry.failed)
+        {
+            result = new cMatrixT<T>(system->height, 1);
+            batchSolve(*system, entry, *result);
+        }
+        delete system;
+
+        if(previousWrite.valid())
+        {
+            previousWrite.get();
+            delete previousResult;
+            previousResult = NULL;
+        }
+        if(result != NULL)
+        {
+            previousResult = result;
+            previousWrite = async(launch::async, [result, &entry]() {
+                omp_set_num_threads(1);
+                batchWrite(*result, entry);
+            });
+        }
+    }
+    if(previousWrite.valid())
+    {
+        previousWrite.get();
+    }
+    delete previousResult;
+}
+
+//solves every system listed in a manifest (one file name per line) or found in a directory (.csv and .bin files)
+//results go to outputDirectory as <input name>_X.csv, a summary to BatchReport.csv
+int batchMode(string source, string outputDirectory, bool doublePrecision)
+{
+    silentMode = true;
+    omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
+    omp_set_num_threads(parameters.wantedThreads);
+    applyAffinity();
+    omp_set_max_active_levels(1);//a worker solving a small system keeps its nested regions to itself
+
+    vector<string> names;
+    struct stat sourceInfo, outputInfo;
+    if(stat(source.c_str(), &sourceInfo) != 0){
+        cout<<"Cannot open files."<<endl;
+        return 1;
+    }
+    if(stat(outputDirectory.c_str(), &outputInfo) != 0 || !S_ISDIR(outputInfo.st_mode) || access(outputDirectory.c_str(), W_OK) != 0){
+        cout<<"Cannot write files."<<endl;//checked once, not for every result
+        return 1;
+    }
+    if(S_ISDIR(sourceInfo.st_mode))
+    {
+        DIR* directory = opendir(source.c_str());
+        struct dirent* item;
+        while(directory != NULL && (item = readdir(directory)) != NULL)
+        {
+            string name = item->d_name;
+            if(name.size() > 4 && (name.compare(name.size() - 4, 4, ".csv") == 0 || name.compare(name.size() - 4, 4, ".bin") == 0))
+            {
+                names.push_back(source + "/" + name);
+            }
+        }
+        if(directory != NULL)
+        {
+            closedir(directory);
+        }
+        sort(names.begin(), names.end());
+    }
+    else
+    {
+        ifstream manifest(source);
+        string line;
+        while(getline(manifest, line))
+        {
+            while(!line.empty() && isspace((unsigned char)line.back()))
+            {
+                line.pop_back();
+            }
+            if(!line.empty() && line[0] != '#')
+            {
+                names.push_back(line);
+            }
+        }
+    }
+
+    vector<batchEntry> entries(names.size());
+    vector<batchEntry*> tiny;
+    vector<batchEntry*> small;
+    vector<batchEntry*> large;
+    for (size_t e = 0; e < names.size(); e++)
+    {
+        batchEntry& entry = entries[e];
+        string base = names[e].substr(names[e].find_last_of('/') + 1);
+        base = base.substr(0, base.find_last_of('.'));
+        entry.name = names[e];
+        entry.outputName = outputDirectory + "/" + base + "_X.csv";
+        entry.height = peekHeight(names[e]);
+        entry.loadTime = entry.solveTime = entry.writeTime = 0;
+        entry.omitted = 0;
+        entry.failed = (entry.height < 1);
+        if(entry.failed)
+        {
             continue;
         }
+        (entry.height <= fixedMaximum ? tiny : entry.height < batchLargeSystem ? small : large).push_back(&entry);
+    }
 
-        if(sizeof(optionChosen)==sizeof(int))
+    cout<<"Batch: "<<names.size()<<" systems, "<<tiny.size()<<" tiny, "<<small.size()<<" small, "<<large.size()<<" large."<<endl;
+    double time = omp_get_wtime();
+    if(doublePrecision)
+    {
+        batchTiny<double>(tiny);
+        batchSmall<double>(small);
+        batchLarge<double>(large);
+    }
+    else
+    {
+        batchTiny<float>(tiny);
+        batchSmall<float>(small);
+        batchLarge<float>(large);
+    }
+    time = omp_get_wtime() - time;
+
+    ofstream report(outputDirectory + "/BatchReport.csv");
+    report<<"file;equations;load time;solve time;write time;omitted rows;status"<<endOfLine;
+    int solved = 0;
+    for (size_t e = 0; e < entries.size(); e++)
+    {
+        batchEntry& entry = entries[e];
+        string status = entry.failed ? "error" : (entry.omitted > 0 ? "rows omitted" : "OK");
+        solved += !entry.failed;
+        report<<entry.name<<";"<<entry.height<<";"<<entry.loadTime<<";"<<entry.solveTime<<";"<<entry.writeTime<<";"
+            <<entry.omitted<<";"<<status<<endOfLine;
+        cout<<entry.name<<": "<<entry.height<<" equations, load "<<entry.loadTime<<" s, solve "<<entry.solveTime
+            <<" s, write "<<entry.writeTime<<" s, "<<status<<endOfLine;
+    }
+
+    cout<<"Batch time: "<<time<<", systems solved: "<<solved<<" of "<<entries.size()
+        <<", systems per second: "<<solved/max(time, 1e-9)<<endl;
+    silentMode = false;
+    dataLogger += endOfLine;
+    dataLogger += "Batch run: ";
+    dataLogger += source;
+    dataLogger += ", time: ";
+    dataLogger += currentDateTime();
+    dataLogger += ", systems: ";
+    dataLogger += to_string(entries.size());
+    dataLogger += ", solved: ";
+    dataLogger += to_string(solved);
+    dataLogger += ", batch time: ";
+    dataLogger += to_string(time);
+    updateDataLog();
+    profileWrite("batch");
+    return (solved == (int)entries.size()) ? 0 : 1;
+}
+
+#ifdef GAUSS_USE_MPI
+//*************distributed elimination (MPI)*******************************
+//the augmented matrix is distributed over a P x Q process grid in blocks of nb x nb, block-cyclic in both
+//directions; built with mpicxx -DGAUSS_USE_MPI and run with mpirun -np <P*Q> ge --mpi
+
+template <typename T> MPI_Datatype mpiType();
+template <> MPI_Datatype mpiType<float>(){ return MPI_FLOAT; }
+template <> MPI_Datatype mpiType<double>(){ return MPI_DOUBLE; }
+template <typename T> MPI_Datatype mpiPairType();
+template <> MPI_Datatype mpiPairType<float>(){ return MPI_FLOAT_INT; }
+template <> MPI_Datatype mpiPairType<double>(){ return MPI_DOUBLE_INT; }
+
+//indices owned by process iproc of nprocs for n indices dealt in blocks of nb
+int ownedCount(int n, int nb, int iproc, int nprocs)
+{
+    int blocks = n/nb;
+    int count = (blocks/nprocs)*nb;
+    if(blocks%nprocs > iproc)
+    {
+        count += nb;
+    }
+    else if(blocks%nprocs == iproc)
+    {
+        count += n%nb;
+    }
+    return count;
+}
+
+//local index of the first owned global index at or after g
+int ownedBefore(int g, int nb, int iproc, int nprocs)
+{
+    return ownedCount(g, nb, iproc, nprocs);
+}
+
+int globalIndex(int local, int nb, int iproc, int nprocs)
+{
+    return ((local/nb)*nprocs + iproc)*nb + local%nb;
+}
+
+template <typename T>
+struct distributedMatrix{
+    int n, width, nb;//global equations, global columns and block size
+    int P, Q, pr, pc;//process grid and the coordinates of this process
+    int rows, cols;//local sizes
+    vector<T> a;//local rows, cols elements each
+    MPI_Comm rowComm, colComm;//processes of the same process row, of the same process column
+
+    T* row(int local){ return a.data() + (size_t)local*cols; }
+    int ownerRow(int g) const { return (g/nb)%P; }
+    int ownerCol(int g) const { return (g/nb)%Q; }
+    int localRow(int g) const { return (g/(nb*P))*nb + g%nb; }
+    int localCol(int g) const { return (g/(nb*Q))*nb + g%nb; }
+    int rowsFrom(int g) const { return ownedBefore(g, nb, pr, P); }//first local row at or below global row g
+    int colsFrom(int g) const { return ownedBefore(g, nb, pc, Q); }
+};
+
+//every process reads only its own blocks - from a mapped binary file directly, from the text only the fields
+//of its rows and columns are parsed
+template <typename T>
+bool readDistributed(string name, distributedMatrix<T>& m)
+{
+    int sourceFile = open(name.c_str(), O_RDONLY);
+    struct stat fileInfo;
+    if(sourceFile < 0 || fstat(sourceFile, &fileInfo) != 0 || fileInfo.st_size == 0)
+    {
+        if(sourceFile >= 0)
         {
-            parameters.chunkSize = optionChosen;
-            break;
+            close(sourceFile);
         }
+        return false;
+    }
+    size_t fileSize = fileInfo.st_size;
+    void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, sourceFile, 0);
+    close(sourceFile);
+    if(mapped == MAP_FAILED)
+    {
+        return false;
+    }
+    const char* text = (const char*)mapped;
+    const char* end = text + fileSize;
+    bool valid = true;
 
-        else
+    if(fileSize >= sizeof(binaryHeader) && memcmp(text, "GEMB", 4) == 0)
+    {
+        binaryHeader header;
+        memcpy(&header, text, sizeof(header));
+        valid = header.version == binaryVersion && !header.hasPermutation && header.height == m.n && header.width == m.width
+            && header.ld >= header.width && (header.scalarSize == sizeof(float) || header.scalarSize == sizeof(double))
+            && fileSize >= sizeof(header) + (size_t)header.height*header.ld*header.scalarSize;
+        const char* block = text + sizeof(header);
+        #pragma omp parallel for schedule(static) if(valid)
+        for (int l = 0; l < m.rows; l++)
         {
-            cout<<"Choose a correct value."<<endl;
+            size_t rowStart = (size_t)globalIndex(l, m.nb, m.pr, m.P)*header.ld;
+            T* rowL = m.row(l);
+            for (int c = 0; c < m.cols; c++)
+            {
+                size_t element = rowStart + globalIndex(c, m.nb, m.pc, m.Q);
+                rowL[c] = (header.scalarSize == sizeof(float)) ? (T)((const float*)block)[element] : (T)((const double*)block)[element];
+            }
+        }
+    }
+    else
+    {
+        vector<const char*> lineStart;//lines of the own rows and the end of the last of them
+        const char* p = (const char*)memchr(text, '\n', fileSize);
+        for (int i = 0; i < m.n && p != NULL; i++)
+        {
+            const char* next = (const char*)memchr(p + 1, '\n', end - p - 1);
+            if(m.ownerRow(i) == m.pr)
+            {
+                lineStart.push_back(p + 1);
+                lineStart.push_back(next != NULL ? next : end);
+            }
+            p = next;
+        }
+        valid = ((int)lineStart.size() == 2*m.rows);
+        #pragma omp parallel for schedule(static) if(valid)
+        for (int l = 0; l < m.rows; l++)
+        {
+            T* rowL = m.row(l);
+            const char* field = lineStart[2*l];
+            const char* lineEnd = lineStart[2*l + 1];
+            for (int j = 0; j < m.width; j++)
+            {
+                const char* next = (field < lineEnd) ? (const char*)memchr(field, ';', lineEnd - field) : NULL;
+                const char* fieldEnd = (next != NULL) ? next : lineEnd;
+                if(m.ownerCol(j) == m.pc)
+                {
+                    T* value = rowL + m.localCol(j);
+                    *value = 0;//missing values are read as 0
+                    if(field < lineEnd)
+                    {
+                        parseValue(field, fieldEnd, value);
+                    }
+                }
+                field = (next != NULL) ? next + 1 : lineEnd;
+            }
         }
+    }
+    munmap(mapped, fileSize);
+    return valid;
+}
 
-    }while(1);
+//exchanges global rows g1 and g2 in count local columns from c0 on, between process rows when needed
+template <typename T>
+void distributedSwap(distributedMatrix<T>& m, int g1, int g2, int c0, int count)
+{
+    if(g1 == g2 || count <= 0)
+    {
+        return;
+    }
+    int owner1 = m.ownerRow(g1);
+    int owner2 = m.ownerRow(g2);
+    if(owner1 == m.pr && owner2 == m.pr)
+    {
+        swap_ranges(m.row(m.localRow(g1)) + c0, m.row(m.localRow(g1)) + c0 + count, m.row(m.localRow(g2)) + c0);
+    }
+    else if(owner1 == m.pr)
+    {
+        MPI_Sendrecv_replace(m.row(m.localRow(g1)) + c0, count, mpiType<T>(), owner2, 0, owner2, 0, m.colComm, MPI_STATUS_IGNORE);
+    }
+    else if(owner2 == m.pr)
+    {
+        MPI_Sendrecv_replace(m.row(m.localRow(g2)) + c0, count, mpiType<T>(), owner1, 0, owner1, 0, m.colComm, MPI_STATUS_IGNORE);
+    }
+}
 
-    do{
-        cout<<"Choose a desired number of threads:"<<endl;
-        cin.clear();
-        cin.ignore(10000,'\n');
+//right-looking LU of the distributed augmented matrix: the process column of a panel factors it with a
+//distributed pivot search, the pivots are applied to the rest of the rows, the panel is broadcast along
+//process rows, the row of U blocks along process columns, and every process updates its trailing blocks
+//returns the number of omitted rows
+template <typename T>
+int distributedFactor(distributedMatrix<T>& m)
+{
+    int n = m.n;
+    int nb = m.nb;
+    int index = 0;
+    vector<int> ipiv(nb);
+    vector<T> pivotRow(nb);
+    vector<T> lPanel, uPanel;
 
-        cin>>optionChosen;
+    for (int k0 = 0; k0 < n; k0 += nb)
+    {
+        int k1 = min(k0 + nb, n);
+        int width = k1 - k0;
+        int panelCol = m.ownerCol(k0);
+        int panelRow = m.ownerRow(k0);
+        int r0 = m.rowsFrom(k0);//local rows of the panel, from its diagonal block down
+        int below = m.rows - r0;
 
-        if(cin.fail()){
-            cout<<"Choose a correct value."<<endl;
-            continue;
+        //panel factorization in the process column of the panel
+        if(m.pc == panelCol)
+        {
+            int lc = m.localCol(k0);
+            for (int j = k0; j < k1; j++)
+            {
+                int c = lc + j - k0;
+                struct { T value; int row; } local = { (T)-1, INT_MAX }, best;
+                profileMark start = profileClock();
+                for (int l = m.rowsFrom(j); l < m.rows; l++)
+                {
+                    T value = abs(m.row(l)[c]);
+                    if(value > local.value)
+                    {
+                        local.value = value;
+                        local.row = globalIndex(l, nb, m.pr, m.P);
+                    }
+                }
+                MPI_Allreduce(&local, &best, 1, mpiPairType<T>(), MPI_MAXLOC, m.colComm);
+                profileAdd(phasePivotSearch, start);
+
+                ipiv[j - k0] = (best.value > 0) ? best.row : j;
+                start = profileClock();
+                distributedSwap(m, j, ipiv[j - k0], lc, width);//the whole panel width, the multipliers move with their rows
+                profileAdd(phaseRowSwap, start);
+                if(best.value <= 0)//rows with maximum element equal to 0 are omitted
+                {
+                    index++;
+                    continue;
+                }
+
+                int owner = m.ownerRow(j);
+                if(owner == m.pr)
+                {
+                    const T* rowJ = m.row(m.localRow(j));
+                    copy(rowJ + c, rowJ + lc + width, pivotRow.begin());
+                }
+                MPI_Bcast(pivotRow.data(), lc + width - c, mpiType<T>(), owner, m.colComm);
+
+                start = profileClock();
+                T inverse = 1/pivotRow[0];
+                #pragma omp parallel for schedule(runtime)
+                for (int l = m.rowsFrom(j + 1); l < m.rows; l++)
+                {
+                    T* rowL = m.row(l);
+                    T multiplier = rowL[c]*inverse;
+                    rowL[c] = multiplier;
+                    rowUpdate(rowL + c + 1, pivotRow.data() + 1, multiplier, lc + width - c - 1);
+                }
+                profileAdd(phasePanel, start);
+            }
+            lPanel.resize((size_t)below*width);
+            for (int l = 0; l < below; l++)
+            {
+                copy(m.row(r0 + l) + lc, m.row(r0 + l) + lc + width, lPanel.begin() + (size_t)l*width);
+            }
         }
 
-        if(sizeof(optionChosen)==sizeof(int))
+        //pivots to the columns right of the panel, the columns to the left are not needed any more
+        MPI_Bcast(ipiv.data(), width, MPI_INT, panelCol, m.rowComm);
+        int c1 = m.colsFrom(k1);
+        profileMark start = profileClock();
+        for (int j = k0; j < k1; j++)
+        {
+            distributedSwap(m, j, ipiv[j - k0], c1, m.cols - c1);
+        }
+        profileAdd(phaseRowSwap, start);
+
+        lPanel.resize((size_t)below*width);
+        MPI_Bcast(lPanel.data(), below*width, mpiType<T>(), panelCol, m.rowComm);
+
+        //row of U blocks - solved with the unit lower triangle of the diagonal block, then sent down the columns
+        int right = m.cols - c1;
+        uPanel.resize((size_t)width*right);
+        if(m.pr == panelRow && right > 0)
         {
-            parameters.wantedThreads = optionChosen;
-            break;
+            start = profileClock();
+            for (int i = 0; i < width; i++)
+            {
+                const T* rowI = m.row(r0 + i) + c1;
+                for (int r = i + 1; r < width; r++)
+                {
+                    rowUpdate(m.row(r0 + r) + c1, rowI, lPanel[(size_t)r*width + i], right);
+                }
+            }
+            for (int i = 0; i < width; i++)
+            {
+                copy(m.row(r0 + i) + c1, m.row(r0 + i) + m.cols, uPanel.begin() + (size_t)i*right);
+            }
+            profileAdd(phasePanel, start);
+        }
+        if(right > 0)
+        {
+            MPI_Bcast(uPanel.data(), width*right, mpiType<T>(), panelRow, m.colComm);
         }
 
-        else
+        //trailing update A22 = A22 - L21*U12
+        start = profileClock();
+        int t0 = m.rowsFrom(k1);
+        #pragma omp parallel for schedule(runtime)
+        for (int l = t0; l < m.rows; l++)
         {
-            cout<<"Choose a correct value."<<endl;
+            T* rowL = m.row(l) + c1;
+            const T* multipliers = lPanel.data() + (size_t)(l - r0)*width;
+            for (int p = 0; p < width && right > 0; p++)
+            {
+                rowUpdate(rowL, uPanel.data() + (size_t)p*right, multipliers[p], right);
+            }
         }
+        profileAdd(phaseTrailingUpdate, start);
+    }
+    int omitted = 0;
+    MPI_Allreduce(&index, &omitted, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    return omitted;
+}
 
-    }while(1);
+//block back substitution from the last block row: the processes of a block row add up their part of U*x,
+//the owner of the diagonal block solves it and sends the new part of x to everybody
+template <typename T>
+void distributedSubstitution(distributedMatrix<T>& m, T* x)
+{
+    int n = m.n;
+    int nb = m.nb;
+    vector<T> partial(nb), sum(nb);
+    for (int k0 = ((n - 1)/nb)*nb; k0 >= 0; k0 -= nb)
+    {
+        int k1 = min(k0 + nb, n);
+        int width = k1 - k0;
+        int blockRow = m.ownerRow(k0);
+        int blockCol = m.ownerCol(k0);
+        if(m.pr == blockRow)
+        {
+            int r0 = m.localRow(k0);
+            int c1 = m.colsFrom(k1);
+            for (int i = 0; i < width; i++)//right-hand side less U*x of the columns already solved
+            {
+                const T* rowI = m.row(r0 + i);
+                T s = 0;
+                for (int c = c1; c < m.cols; c++)
+                {
+                    int g = globalIndex(c, nb, m.pc, m.Q);
+                    s += (g < n) ? rowI[c]*x[g] : -rowI[c];
+                }
+                partial[i] = s;
+            }
+            MPI_Reduce(partial.data(), sum.data(), width, mpiType<T>(), MPI_SUM, blockCol, m.rowComm);
+            if(m.pc == blockCol)
+            {
+                int lc = m.localCol(k0);
+                for (int i = width - 1; i >= 0; i--)
+                {
+                    const T* rowI = m.row(r0 + i) + lc;
+                    T s = -sum[i];
+                    for (int j = i + 1; j < width; j++)
+                    {
+                        s -= rowI[j]*x[k0 + j];
+                    }
+                    x[k0 + i] = (rowI[i] == 0) ? 0 : s/rowI[i];
+                }
+            }
+        }
+        MPI_Bcast(x + k0, width, mpiType<T>(), blockRow*m.Q + blockCol, MPI_COMM_WORLD);
+    }
 }
 
-cMatrix matrixGaussianElimination(cMatrix* matrixArg, bool* errors)
-//gives the Gaussian elimination solution vector (matrix type) of a given matrix
+//distributed solution - every rank reads its share, the factorization and the substitution run on the grid,
+//rank 0 writes the solution and the same timings as the shared-memory solver
+template <typename T>
+int distributedMode(string source, int P, int Q, int nb, string nameOutput)
 {
-    /*taken from an omp enum sched type declaration
-    omp_sched_static = 1,
-    omp_sched_dynamic = 2,
-    omp_sched_guided = 3,
-    omp_sched_auto = 4
-    */
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm host;//ranks on this host place their threads one after another
+    int hostRank = 0;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &host);
+    MPI_Comm_rank(host, &hostRank);
+    MPI_Comm_free(&host);
+    affinityOffset = hostRank*parameters.wantedThreads;
     omp_set_schedule(parameters.scheduleType,parameters.chunkSize);
     omp_set_num_threads(parameters.wantedThreads);
-    int index = 0;
-    double time;
-
-    dataLogger += endOfLine;
-    dataLogger += "Gaussian elimination time: ";
-    dataLogger += currentDateTime();
-    dataLogger += ", amount of equations: ";
-    dataLogger += to_string(matrixArg->height);
-    dataLogger += ", ";
-    dataLogger += "parallel schedule type: ";
-    switch (parameters.scheduleType)
+    applyAffinity();
+    if(P < 1 || Q < 1 || P*Q != size)
     {
-        case 1:
-            dataLogger += "static";
-            break;
-        case 2:
-            dataLogger += "dynamic";
-            break;
-        case 3:
-            dataLogger += "guided";
-            break;
-        case 4:
-            dataLogger += "auto";
-            break;
-        default:
-            dataLogger += "unknown";
-    }
-    dataLogger += ", ";
-    dataLogger += "parallel size of chunk: ";
-    dataLogger += to_string(parameters.chunkSize);
-    dataLogger += ", ";
-    dataLogger += "parallel wanted number of threads: ";
-    dataLogger += to_string(parameters.wantedThreads);
-    dataLogger += ", ";
-
-    if (matrixArg->errorFlag){
-        std::cout<<"Input error."<<std::endl;
-        dataLogger += "Input error.";
-        *errors = true;
-        cMatrix result = cMatrix(1, 1);
-        return result;
+        for (P = (int)sqrt((double)size); size%P != 0; P--);
+        Q = size/P;
     }
 
-    if (matrixArg->width!=(matrixArg->height)+1){
-        std::cout<<"Dimension mismatch. Elimination."<<std::endl;
-        dataLogger += "Dimension mismatch. Elimination.";
-        *errors = true;
-        cMatrix result = cMatrix(1, 1);
-        return result;
+    //size of the system - the first value of the text or the binary header, read by rank 0
+    int n = (rank == 0) ? peekHeight(source) : 0;
+    MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if(n < 1)
+    {
+        if(rank == 0)
+        {
+            cout<<"Cannot read files."<<endl;
+        }
+        return 1;
     }
 
-    cMatrix result = cMatrix(matrixArg->height, 1);//result declaration
-    cMatrix tmp = cMatrix(*matrixArg);//to keep original input values a matrix copy is created
+    distributedMatrix<T> m;
+    m.n = n;
+    m.width = n + 1;
+    m.nb = max(1, min(nb, n));
+    m.P = P;
+    m.Q = Q;
+    m.pr = rank/Q;
+    m.pc = rank%Q;
+    m.rows = ownedCount(n, m.nb, m.pr, P);
+    m.cols = ownedCount(m.width, m.nb, m.pc, Q);
+    m.a.assign((size_t)m.rows*m.cols, 0);
+    MPI_Comm_split(MPI_COMM_WORLD, m.pr, m.pc, &m.rowComm);
+    MPI_Comm_split(MPI_COMM_WORLD, m.pc, m.pr, &m.colComm);
 
-    //*************sequence part*******************************
-    time = omp_get_wtime();
+    double time = MPI_Wtime();
+    int valid = readDistributed(source, m) ? 1 : 0;
+    int allValid = 0;
+    MPI_Allreduce(&valid, &allValid, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    time = MPI_Wtime() - time;
+    double readTime = 0;
+    MPI_Reduce(&time, &readTime, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
 
-    //Stage 1 - elimination
-    for (int i = 0; i < tmp.height; i++)
+    int result = 0;
+    if(!allValid)
     {
-        int maxIndex = i;
-        for (int j = i; j < tmp.height; j++)//searching for a maximum element
+        if(rank == 0)
         {
-            if(abs(tmp.data[j][i])>abs(tmp.data[maxIndex][i]))
-            {
-                maxIndex = j;
-            }
+            cout<<"Cannot read files."<<endl;
         }
-
-        if(maxIndex!=(i))//changing rows if needed
+        result = 1;
+    }
+    else
+    {
+        cMatrixT<T> solution = cMatrixT<T>(n, 1);
+        if(rank == 0)
         {
-            float tmpFloat = 0;//holds initial value for the calculations
-            for(int k = 0; k < tmp.width; k++)
+            cout<<"File reading: OK ("<<readTime<<" s), grid "<<P<<" x "<<Q<<", block "<<m.nb<<endl;
+            if(verification)//sequential reference on rank 0, which needs the whole matrix
             {
-                tmpFloat = tmp.data[i][k];
-                tmp.data[i][k] = tmp.data[maxIndex][k];
-                tmp.data[maxIndex][k] = tmpFloat;
+                cMatrixT<T> whole = cMatrixT<T>(source);
+                cMatrixT<T> reference = cMatrixT<T>(n, 1);
+                time = omp_get_wtime();
+                sequentialElimination(whole, reference);
+                solution.timeSeq = omp_get_wtime() - time;
+                cout<<"Sequence time: "<<solution.timeSeq<<endl;
             }
         }
 
-        if(tmp.data[i][i]==0){//rows with maximum element equal to 0 are omitted
-            index++;
-            *errors = true;
-            continue;
-        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        time = MPI_Wtime();
+        int index = distributedFactor(m);
+        distributedSubstitution(m, solution.row(0));
+        MPI_Barrier(MPI_COMM_WORLD);
+        solution.timePar = MPI_Wtime() - time;
 
-        for (int j = i + 1; j < tmp.height; j++)//reduction
+        if(rank == 0)
         {
-            float tmpFloat = tmp.data[j][i];//holds initial value for the calculations - it would normally change in process
-            for(int k = 0; k < tmp.width; k++)
+            cout<<"Parallel time: "<<solution.timePar<<endl;
+            dataLogger += endOfLine;
+            dataLogger += "Distributed elimination time: ";
+            dataLogger += currentDateTime();
+            dataLogger += ", amount of equations: ";
+            dataLogger += to_string(n);
+            dataLogger += ", processes: ";
+            dataLogger += to_string(size);
+            dataLogger += ", grid: ";
+            dataLogger += to_string(P) + " x " + to_string(Q);
+            dataLogger += ", block size: ";
+            dataLogger += to_string(m.nb);
+            dataLogger += ", sequence time: ";
+            dataLogger += to_string(solution.timeSeq);
+            dataLogger += ", parallel time: ";
+            dataLogger += to_string(solution.timePar);
+            dataLogger += ", ";
+            dataLogger += to_string(index);
+            dataLogger += " rows omitted, ";
+            if(index == 0)
             {
-                tmp.data[j][k] = tmp.data[j][k] - tmpFloat*tmp.data[i][k]/tmp.data[i][i];
+                std::cout<<"Gaussian elimination: OK"<<std::endl;
+                dataLogger += "...OK";
             }
+            else
+            {
+                std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
+                dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+            }
+            solution.mPrint(nameOutput);
+            updateDataLog();
         }
     }
+    profileWrite("distributed, rank " + to_string(rank));
+    MPI_Comm_free(&m.rowComm);
+    MPI_Comm_free(&m.colComm);
+    return result;
+}
+#endif
 
-    //tmp.screenPrint();//reordered input matrix can be printed to the screen
+int main(int argc, char* argv[])
+{
+    bool errors = false;//general error flag
+    string nameInput = "C.csv";//input file name
+    string nameBinaryInput = "C.bin";//binary input file name, used instead of the .csv one when present
+    string nameSparseInput = "C.mtx";//sparse input file name, Matrix Market with the right-hand side as the last column
+    string nameOutput = "X";//output file name
+    string nameFactors = "LU.bin";//stored factors file name
+    string nameRightSides = "B.csv";//block of right-hand sides file name
 
-    //Stage 2 - solution
-    for(int i = result.width-1; i >= 0; i--)
+    int option = 0;//chosen option
+    bool dataFlag = false;//flag for the menu choice validation
+    vector<int> tuningSizes = { 128, 512, 2048 };//one tuning system per size class
+
+    parameters.affinity = affinityFromName(getenv("GAUSS_AFFINITY"));
+
+    //non-interactive batch mode: --batch <manifest or directory> [output directory] [--threads N] [--double]
+    if(argc > 2 && string(argv[1]) == "--batch")
     {
-        float tmpSum = 0;
-        for(int j = i; j < result.width; j++)
+        string outputDirectory = ".";
+        bool doublePrecision = false;
+        for (int a = 3; a < argc; a++)
         {
-            tmpSum += tmp.data[i][j] * result.data[0][j];
+            string argument = argv[a];
+            if(argument == "--threads" && a + 1 < argc)
+            {
+                parameters.wantedThreads = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--double")
+            {
+                doublePrecision = true;
+            }
+            else
+            {
+                outputDirectory = argument;
+            }
         }
-        result.data[0][i] = (tmp.data[i][tmp.width-1] - tmpSum)/tmp.data[i][i];
+        return batchMode(argv[2], outputDirectory, doublePrecision);
     }
 
-    time = omp_get_wtime() - time;
-    result.timeSeq = time;
-
-    std::cout<<"Sequence time: "<<result.timeSeq<<std::endl;
-    dataLogger += "sequence time: ";
-    dataLogger += to_string(result.timeSeq);
-    dataLogger += ", ";
-    dataLogger += to_string(index);
-    dataLogger += " rows omitted in sequence part, ";
-    index = 0;
-
-    //*************parallel part*******************************
-    cMatrix tmp2 = cMatrix(*matrixArg);//to keep original input values a matrix copy is created
-    //second copy of the data for parallel algorithm to start from the beginning
-    cMatrix result2 = cMatrix(matrixArg->height, 1);//result declaration
-    time = omp_get_wtime();
-
-    //Stage 1 - elimination
-
-    for (int i = 0; i < tmp2.height; i++)
+    //benchmark on generated systems: --benchmark [comma separated sizes] [--trials N] [--warmup N] [--threads N]
+    //[--kind random|dominant|kms] [--output name]
+    if(argc > 1 && string(argv[1]) == "--benchmark")
     {
-        int maxIndex = i;
-
-        ///*
-        #pragma omp parallel shared(maxIndex)
+        vector<int> sizes = { 250, 500, 1000 };
+        systemKind kind = systemRandom;
+        int warmup = 1;
+        int trials = 5;
+        string outputName = "BenchmarkResults";
+        for (int a = 2; a < argc; a++)
         {
-            int localMax = i;
-            #pragma omp for schedule(runtime)
-            for (int j = i; j < tmp2.height; j++)//searching for a maximum element
+            string argument = argv[a];
+            if(argument == "--trials" && a + 1 < argc)
             {
-                if(abs(tmp2.data[j][i])>abs(tmp2.data[localMax][i]))
-                {
-                    localMax = j;
-                }
+                trials = max(1, atoi(argv[++a]));
             }
-            #pragma omp critical
+            else if(argument == "--warmup" && a + 1 < argc)
             {
-                if(abs(tmp2.data[localMax][i])>abs(tmp2.data[maxIndex][i]))
-                {
-                    maxIndex = localMax;
-                }
+                warmup = max(0, atoi(argv[++a]));
             }
-        }
-        //*/
-        /*
-        for (int j = i; j < tmp2.height; j++)//searching for a maximum element
+            else if(argument == "--threads" && a + 1 < argc)
+            {
+                parameters.wantedThreads = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--kind" && a + 1 < argc)
+            {
+                string name = argv[++a];
+                kind = (name == "dominant") ? systemDominant : (name == "kms") ? systemKms : systemRandom;
+            }
+            else if(argument == "--output" && a + 1 < argc)
+            {
+                outputName = argv[++a];
+            }
+            else
             {
-                if(abs(tmp2.data[j][i])>abs(tmp2.data[maxIndex][i]))
+                sizes.clear();
+                stringstream list(argument);
+                string item;
+                while(getline(list, item, ','))
                 {
-                    maxIndex = j;
+                    if(atoi(item.c_str()) > 0)
+                    {
+                        sizes.push_back(atoi(item.c_str()));
+                    }
                 }
             }
-        */
+        }
+        return benchmarkMode(sizes, kind, warmup, trials, outputName);
+    }
 
-        if(maxIndex!=(i))//changing rows if needed
+    //throughput of many small systems: --tiny [comma separated sizes up to 16] [--count N] [--threads N] [--double]
+    if(argc > 1 && string(argv[1]) == "--tiny")
+    {
+        vector<int> sizes = { 3, 4, 8, 16 };
+        int count = 1 << 20;
+        bool doublePrecision = false;
+        for (int a = 2; a < argc; a++)
         {
-            #pragma omp parallel shared(tmp2)
+            string argument = argv[a];
+            if(argument == "--count" && a + 1 < argc)
             {
-                float tmpFloat = 0;//holds initial value for the calculations
-                #pragma omp for schedule(runtime) nowait
-                for(int k = 0; k < tmp2.width; k++)
+                count = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--threads" && a + 1 < argc)
+            {
+                parameters.wantedThreads = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--double")
+            {
+                doublePrecision = true;
+            }
+            else
+            {
+                sizes.clear();
+                stringstream list(argument);
+                string item;
+                while(getline(list, item, ','))
                 {
-                    tmpFloat = tmp2.data[i][k];
-                    tmp2.data[i][k] = tmp2.data[maxIndex][k];
-                    tmp2.data[maxIndex][k] = tmpFloat;
+                    if(atoi(item.c_str()) > 0)
+                    {
+                        sizes.push_back(atoi(item.c_str()));
+                    }
                 }
             }
         }
+        return doublePrecision ? tinyMode<double>(sizes, count) : tinyMode<float>(sizes, count);
+    }
 
-        if(tmp2.data[i][i]==0){//rows with maximum element equal to 0 are omitted
-            index++;
-            *errors = true;
-            continue;
-        }
-
-        for (int j = i + 1; j < tmp2.height; j++)//reduction
+    //autotuning of the parallel options: --autotune [comma separated sizes] [--trials N]
+    if(argc > 1 && string(argv[1]) == "--autotune")
+    {
+        int trials = 3;
+        for (int a = 2; a < argc; a++)
         {
-            float tmpFloat = tmp2.data[j][i];//holds initial value for the calculations - it would normally change in process
-            //#pragma omp parallel lastprivate(tmp2)
+            string argument = argv[a];
+            if(argument == "--trials" && a + 1 < argc)
+            {
+                trials = max(1, atoi(argv[++a]));
+            }
+            else
             {
-                //#pragma omp for schedule(runtime)
-                for(int k = 0; k < tmp2.width; k++)
+                tuningSizes.clear();
+                stringstream list(argument);
+                string item;
+                while(getline(list, item, ','))
                 {
-                    tmp2.data[j][k] = tmp2.data[j][k] - tmpFloat*tmp2.data[i][k]/tmp2.data[i][i];
+                    if(atoi(item.c_str()) > 0)
+                    {
+                        tuningSizes.push_back(atoi(item.c_str()));
+                    }
                 }
             }
         }
+        return autotuneMode(tuningSizes, trials);
     }
 
-    //cout<<index<<" rows omitted."<<endl;//rows omitted can be printed to the screen
-    //tmp2.screenPrint();//reordered input matrix can be printed to the screen
-
-    //Stage 2 - solution
-    for(int i = result2.width-1; i >= 0; i--)
+    //out-of-core solution: --out-of-core [input] [--budget MB] [--double] [--threads N]
+    if(argc > 1 && string(argv[1]) == "--out-of-core")
     {
-        float tmpSum = 0;
-        #pragma omp parallel shared(tmpSum)
+        string source = (access(nameBinaryInput.c_str(), R_OK) == 0) ? nameBinaryInput : nameInput;
+        int budget = outOfCoreBudget;
+        bool doublePrecision = false;
+        for (int a = 2; a < argc; a++)
         {
-            float tmpSumLocal = 0;
-            #pragma omp for schedule(runtime)
-            for(int j = i; j < result2.width; j++)
+            string argument = argv[a];
+            if(argument == "--budget" && a + 1 < argc)
+            {
+                budget = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--threads" && a + 1 < argc)
             {
-                tmpSumLocal += tmp2.data[i][j] * result2.data[0][j];
+                parameters.wantedThreads = max(1, atoi(argv[++a]));
             }
-            #pragma omp critical
+            else if(argument == "--double")
             {
-                tmpSum += tmpSumLocal;
+                doublePrecision = true;
+            }
+            else
+            {
+                source = argument;
             }
         }
-        result2.data[0][i] = (tmp2.data[i][tmp2.width-1] - tmpSum)/tmp2.data[i][i];
+        return doublePrecision ? outOfCoreMode<double>(source, budget, nameOutput) : outOfCoreMode<float>(source, budget, nameOutput);
     }
 
-    time = omp_get_wtime() - time;
-    result.timePar = time;
-
-    std::cout<<"Parallel time: "<<result.timePar<<std::endl;
-    dataLogger += "parallel time: ";
-    dataLogger += to_string(result.timePar);
-    dataLogger += ", ";
-    dataLogger += to_string(index);
-    dataLogger += " rows omitted in parallel part, ";
-
-    result2.timePar = result.timePar;
-    result2.timeSeq = result.timeSeq;//to prevent both sections to interfere with each other they operate on separate
-    //copies of input data and solution vector; tmp and result for sequence while tmp2 and result2 for parallel
-
-    if(index == 0)
+    //distributed solution on a process grid: mpirun -np N ge --mpi [input] [--grid PxQ] [--block B] [--double]
+    //[--threads N] [--verify]
+    if(argc > 1 && string(argv[1]) == "--mpi")
     {
-        std::cout<<"Gaussian elimination: OK"<<std::endl;
-        dataLogger += "...OK";
+#ifdef GAUSS_USE_MPI
+        string source = (access(nameBinaryInput.c_str(), R_OK) == 0) ? nameBinaryInput : nameInput;
+        int P = 0, Q = 0;
+        int blockSize = 64;
+        bool doublePrecision = false;
+        for (int a = 2; a < argc; a++)
+        {
+            string argument = argv[a];
+            if(argument == "--grid" && a + 1 < argc)
+            {
+                sscanf(argv[++a], "%dx%d", &P, &Q);
+            }
+            else if(argument == "--block" && a + 1 < argc)
+            {
+                blockSize = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--threads" && a + 1 < argc)
+            {
+                parameters.wantedThreads = max(1, atoi(argv[++a]));
+            }
+            else if(argument == "--double")
+            {
+                doublePrecision = true;
+            }
+            else if(argument == "--verify")
+            {
+                verification = true;
+            }
+            else
+            {
+                source = argument;
+            }
+        }
+        int provided = 0;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+        int result = doublePrecision ? distributedMode<double>(source, P, Q, blockSize, nameOutput)
+            : distributedMode<float>(source, P, Q, blockSize, nameOutput);
+        MPI_Finalize();
+        return result;
+#else
+        cout<<"This build has no MPI support, build it with mpicxx -DGAUSS_USE_MPI."<<endl;
+        return 1;
+#endif
     }
-    else
+
+    //interactive run with the sequential reference check of every solve
+    if(argc > 1 && string(argv[1]) == "--verify")
     {
-        std::cout<<"Gaussian elimination: OK - some rows were omitted, so the result is incorrect."<<std::endl;
-        dataLogger += "...OK - some rows were omitted, so the result is incorrect.";
+        verification = true;
     }
-    *errors = false;
-    return result2;
-}
-
-int main()
-{
-    bool errors = false;//general error flag
-    string nameInput = "C.csv";//input file name
-    string nameOutput = "X";//output file name
-
-    int option = 0;//chosen option
-    bool dataFlag = false;//flag for the menu choice validation
 
 
 
@@ -671,13 +6761,23 @@ int main()
             if(option!=1)
             {
                 updateDataLog();
+                profileWrite("menu option " + to_string(option));
             }
+            string source = (access(nameBinaryInput.c_str(), R_OK) == 0) ? nameBinaryInput : nameInput;
             cout<<"*******************************"<<endl;
             cout<<"Choose 1 to see the dataLogger:"<<endl;
             cout<<"Choose 2 to exit:"<<endl;
             cout<<"Choose 3 to read a file:"<<endl;
             cout<<"Choose 4 to perform task:"<<endl;
             cout<<"Choose 5 to change parallel execution options:"<<endl;
+            cout<<"Choose 6 to factorize the matrix and store the factors:"<<endl;
+            cout<<"Choose 7 to solve the stored factors for the right-hand sides:"<<endl;
+            cout<<"Choose 8 to change precision:"<<endl;
+            cout<<"Choose 9 to convert files between .csv and the binary format:"<<endl;
+            cout<<"Choose 10 to autotune the parallel execution options on this machine:"<<endl;
+            cout<<"Choose 11 to switch between the production and the verification mode:"<<endl;
+            cout<<"Choose 12 to change the matrix structure hint:"<<endl;
+            cout<<"Choose 13 to solve a sparse system (Matrix Market):"<<endl;
 
             cin.clear();
 
@@ -703,17 +6803,30 @@ int main()
             }
 
             else if (option==3){
-                cMatrix matrixA = cMatrix(nameInput);
+                cMatrix matrixA = cMatrix(source);
                 if (matrixA.errorFlag)
                 {
                     cout<<"Error."<<endl;
                 }
             }
 
+            else if (option ==4 && precision == precisionFloat){
+                cMatrix matrixA = cMatrix(source);
+
+                cMatrix matrixX = cMatrix(matrixGaussianElimination(&matrixA, &errors, true));
+                if(!errors){
+                    matrixX.mPrint(nameOutput);
+                }
+                else{
+                    cout<<"Error."<<endl;
+                }
+            }
+
             else if (option ==4){
-                cMatrix matrixA = cMatrix(nameInput);
+                cMatrixD matrixA = cMatrixD(source);
 
-                cMatrix matrixX = cMatrix(matrixGaussianElimination(&matrixA, &errors));
+                cMatrixD matrixX = cMatrixD(precision == precisionDouble ? matrixGaussianElimination(&matrixA, &errors, true)
+                    : matrixMixedElimination(&matrixA, &errors));
                 if(!errors){
                     matrixX.mPrint(nameOutput);
                 }
@@ -726,6 +6839,73 @@ int main()
                 parallelOptionChange();
             }
 
+            else if (option ==6){
+                cMatrix matrixA = cMatrix(source);
+
+                cMatrix matrixLU = cMatrix(matrixFactorization(&matrixA, &errors));
+                if(errors || !storeFactors(matrixLU, nameFactors)){
+                    cout<<"Error."<<endl;
+                }
+            }
+
+            else if (option ==7){
+                cMatrix matrixLU = cMatrix(nameFactors);//mapped in place
+                cMatrix matrixB = cMatrix(nameRightSides, layoutBlock);
+
+                cMatrix matrixX = cMatrix(matrixSolve(&matrixLU, &matrixB, &errors));
+                if(!errors){
+                    matrixX.mPrint(nameOutput);
+                }
+                else{
+                    cout<<"Error."<<endl;
+                }
+            }
+
+            else if (option ==8){
+                precisionOptionChange();
+            }
+
+            else if (option ==9){
+                fileConversion();
+            }
+
+            else if (option ==10){
+                autotuneMode(tuningSizes, 3);
+            }
+
+            else if (option ==11){
+                verification = !verification;
+                cout<<(verification ? "Verification mode - every solve is checked against the sequential elimination."
+                    : "Production mode - only the selected parallel engine is run.")<<endl;
+                dataLogger += endOfLine;
+                dataLogger += verification ? "Verification mode on: " : "Verification mode off: ";
+                dataLogger += currentDateTime();
+            }
+
+            else if (option ==12){
+                structureOptionChange();
+            }
+
+            else if (option ==13 && precision == precisionFloat){
+                cMatrix matrixX = cMatrix(matrixSparseElimination<float>(nameSparseInput, &errors));
+                if(!errors){
+                    matrixX.mPrint(nameOutput);
+                }
+                else{
+                    cout<<"Error."<<endl;
+                }
+            }
+
+            else if (option ==13){
+                cMatrixD matrixX = cMatrixD(matrixSparseElimination<double>(nameSparseInput, &errors));
+                if(!errors){
+                    matrixX.mPrint(nameOutput);
+                }
+                else{
+                    cout<<"Error."<<endl;
+                }
+            }
+
             else{
                 cout<<"Choose a correct value."<<endl;
                 continue;